@@ -0,0 +1,2621 @@
+#ifndef ARBOL_HPP
+#define ARBOL_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <map>
+#include <unordered_map>
+#include <type_traits>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <ctime>
+#include <random>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <iterator>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+
+// Biblioteca para JSON (asumo que se usa nlohmann/json)
+#include "json.hpp"
+#include "metricas.hpp"
+#include "memoria.hpp"
+#include "simbolos.hpp"
+#include "merkle.hpp"
+
+using json = nlohmann::json;
+using namespace std;
+
+// ==============================================
+// 1. ESTRUCTURAS BASE: TipoNodo y Nodo
+// ==============================================
+
+// Enumeración para el tipo de nodo: Carpeta o Archivo (un byte: va en la parte caliente de Nodo)
+enum class TipoNodo : uint8_t { Carpeta, Archivo };
+
+class Nodo;
+
+/**
+ * @brief Los hijos de un Nodo en un solo puntero (8 bytes, frente a los 24 de vector<Nodo*>).
+ * * Tamaño y capacidad van en una cabecera al principio del bloque reservado; una lista vacía (la de
+ *   todo archivo) no reserva nada. Ofrece la parte de la interfaz de vector que usa el árbol, con
+ *   punteros como iteradores.
+ */
+class ListaHijos {
+private:
+    Nodo** datos = nullptr; // Justo detrás de la cabecera {tamaño, capacidad}; nullptr sin bloque
+
+    uint32_t* cabecera() const { return reinterpret_cast<uint32_t*>(datos) - 2; }
+
+    void liberar() {
+        if (datos) ::operator delete(cabecera());
+        datos = nullptr;
+    }
+
+    // Pasa a un bloque del doble de capacidad (al menos 4)
+    void crecer() {
+        size_t tam = size();
+        size_t capacidad = max<size_t>(4, 2 * this->capacidad());
+        auto* bloque = static_cast<uint32_t*>(::operator new(2 * sizeof(uint32_t) + capacidad * sizeof(Nodo*)));
+        bloque[0] = uint32_t(tam);
+        bloque[1] = uint32_t(capacidad);
+        Nodo** nuevos = reinterpret_cast<Nodo**>(bloque + 2);
+        if (tam) memcpy(nuevos, datos, tam * sizeof(Nodo*));
+        liberar();
+        datos = nuevos;
+    }
+
+public:
+    using iterator = Nodo**;
+    using const_iterator = Nodo* const*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    ListaHijos() = default;
+    ListaHijos(const ListaHijos&) = delete;
+    ListaHijos& operator=(const ListaHijos&) = delete;
+    ~ListaHijos() { liberar(); }
+
+    size_t size() const { return datos ? cabecera()[0] : 0; }
+    size_t capacidad() const { return datos ? cabecera()[1] : 0; }
+    bool empty() const { return size() == 0; }
+
+    iterator begin() { return datos; }
+    iterator end() { return datos + size(); }
+    const_iterator begin() const { return datos; }
+    const_iterator end() const { return datos + size(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    Nodo* operator[](size_t i) const { return datos[i]; }
+    Nodo* back() const { return datos[size() - 1]; }
+
+    void push_back(Nodo* nodo) {
+        if (size() == capacidad()) crecer();
+        datos[cabecera()[0]++] = nodo;
+    }
+
+    iterator insert(const_iterator pos, Nodo* nodo) {
+        size_t i = size_t(pos - begin());
+        push_back(nodo);
+        std::rotate(begin() + i, end() - 1, end());
+        return begin() + i;
+    }
+
+    iterator erase(const_iterator pos) {
+        size_t i = size_t(pos - begin());
+        std::copy(begin() + i + 1, end(), begin() + i);
+        --cabecera()[0];
+        return begin() + i;
+    }
+
+    void clear() {
+        if (datos) cabecera()[0] = 0;
+    }
+
+    // Entrega los hijos y deja la lista vacía y sin bloque
+    vector<Nodo*> soltar() {
+        vector<Nodo*> hijos(begin(), end());
+        liberar();
+        return hijos;
+    }
+
+    size_t bytes() const { return datos ? 2 * sizeof(uint32_t) + capacidad() * sizeof(Nodo*) : 0; }
+};
+
+/**
+ * @brief Índice de los hijos de una carpeta ordenado por nombre (carpetas en modo 'sort on').
+ * * Los hijos están en un array plano ordenado por nombre. Cada entrada lleva los 8 primeros bytes
+ *   del nombre como entero big-endian: casi todas las comparaciones son entre enteros, sin ir a la
+ *   tabla de símbolos. Para buscar se usa una copia de esas claves en disposición de Eytzinger (el
+ *   árbol binario implícito, guardado por niveles): los primeros niveles comparten líneas de caché
+ *   y la lectura de los siguientes se adelanta con prefetch.
+ * * Las altas van a un búfer sin ordenar que se funde con el array al llenarse; el coste O(n) de la
+ *   fusión (y de rehacer la copia) se reparte entre esas altas. El búfer admite TAM_RECIENTES entradas
+ *   o, en carpetas grandes, del orden de sqrt(n): así recorrerlo y fundirlo cuestan O(sqrt(n)) por
+ *   operación. Las bajas dejan una lápida (entrada sin nodo) que desaparece en la siguiente fusión.
+ * * buscar() es O(log n + sqrt(n)) comparaciones de enteros y no modifica nada: admite varios
+ *   lectores a la vez.
+ */
+class IndiceHijos {
+public:
+    static constexpr size_t TAM_RECIENTES = 64;
+
+private:
+    struct Entrada {
+        uint64_t clave;   // 8 primeros bytes del nombre (big-endian, con ceros a la derecha)
+        Nodo* nodo;       // nullptr = lápida
+        Simbolo simbolo;
+    };
+
+    vector<Entrada> ordenadas;
+    vector<Entrada> recientes;  // Sin ordenar
+    vector<uint64_t> eytzinger; // eytzinger[k]: clave del nodo k del árbol implícito (raíz k = 1)
+    vector<uint32_t> posicion;  // posicion[k]: su índice en 'ordenadas'
+    size_t lapidas = 0;
+    size_t limite = TAM_RECIENTES; // Recientes (o lápidas) que disparan una fusión
+
+    static uint64_t claveDe(string_view nombre) {
+        uint64_t clave = 0;
+        for (size_t i = 0; i < 8; ++i) clave = (clave << 8) | (i < nombre.size() ? uint8_t(nombre[i]) : 0);
+        return clave;
+    }
+
+    static string_view texto(const Entrada& e) { return TablaSimbolos::global().texto(e.simbolo); }
+
+    static bool menor(const Entrada& a, const Entrada& b) {
+        return a.clave != b.clave ? a.clave < b.clave : texto(a) < texto(b);
+    }
+
+    static Entrada entradaDe(Nodo* hijo);
+
+    // Rellena el árbol implícito en orden (la profundidad de la recursión es log2 n)
+    void rellenar(size_t k, size_t& i) {
+        if (k >= eytzinger.size()) return;
+        rellenar(2 * k, i);
+        eytzinger[k] = ordenadas[i].clave;
+        posicion[k] = uint32_t(i++);
+        rellenar(2 * k + 1, i);
+    }
+
+    void construirEytzinger() {
+        eytzinger.assign(ordenadas.size() + 1, 0);
+        posicion.assign(ordenadas.size() + 1, 0);
+        size_t i = 0;
+        rellenar(1, i);
+        for (limite = TAM_RECIENTES; limite * limite < ordenadas.size(); limite *= 2) {}
+    }
+
+    // Funde las recientes con las ordenadas y elimina las lápidas
+    void fundir() {
+        ordenadas.erase(std::remove_if(ordenadas.begin(), ordenadas.end(), [](const Entrada& e) { return !e.nodo; }),
+                        ordenadas.end());
+        std::sort(recientes.begin(), recientes.end(), menor);
+        size_t medio = ordenadas.size();
+        ordenadas.insert(ordenadas.end(), recientes.begin(), recientes.end());
+        std::inplace_merge(ordenadas.begin(), ordenadas.begin() + medio, ordenadas.end(), menor);
+        recientes.clear();
+        lapidas = 0;
+        construirEytzinger();
+    }
+
+    // Primer índice de 'ordenadas' con clave >= c ('ordenadas.size()' si no hay)
+    size_t primeraConClave(uint64_t c) const {
+        size_t n = ordenadas.size(), k = 1;
+        while (k <= n) {
+            __builtin_prefetch(eytzinger.data() + min(8 * k, n)); // Tres niveles por delante
+            k = 2 * k + (eytzinger[k] < c);
+        }
+        k >>= __builtin_ffsll(~(long long)k);
+        return k ? posicion[k] : n;
+    }
+
+    // Índice en 'ordenadas' de la primera entrada con ese nombre (lápida o no), o 'ordenadas.size()'
+    size_t buscarOrdenada(string_view nombre, Simbolo simbolo) const {
+        size_t n = ordenadas.size();
+        uint64_t c = claveDe(nombre);
+        size_t i = primeraConClave(c);
+        if (i == n || ordenadas[i].clave != c) return n;
+        if (ordenadas[i].simbolo == simbolo) return i;
+        if (nombre.size() < 8) return n; // La clave ya es el nombre entero
+        // Varios nombres con los mismos 8 primeros bytes: búsqueda binaria por texto en ese tramo
+        size_t fin = (c == UINT64_MAX) ? n : primeraConClave(c + 1);
+        auto it = std::lower_bound(ordenadas.begin() + i, ordenadas.begin() + fin, nombre,
+                                   [](const Entrada& e, string_view v) { return texto(e) < v; });
+        return (it != ordenadas.begin() + fin && it->simbolo == simbolo) ? size_t(it - ordenadas.begin()) : n;
+    }
+
+    // Primer índice de 'ordenadas' cuyo nombre es mayor que 'nombre' ('ordenadas.size()' si no hay)
+    size_t primeraMayor(string_view nombre) const {
+        size_t n = ordenadas.size();
+        uint64_t c = claveDe(nombre);
+        size_t i = primeraConClave(c);
+        if (i == n || ordenadas[i].clave != c) return i;
+        size_t fin = (c == UINT64_MAX) ? n : primeraConClave(c + 1);
+        return size_t(std::upper_bound(ordenadas.begin() + i, ordenadas.begin() + fin, nombre,
+                                       [](string_view v, const Entrada& e) { return v < texto(e); }) - ordenadas.begin());
+    }
+
+public:
+    // Índice de todos los hijos actuales
+    void construir(const ListaHijos& hijos);
+
+    void insertar(Nodo* hijo) {
+        recientes.push_back(entradaDe(hijo));
+        if (recientes.size() >= limite) fundir();
+    }
+
+    // Hay que llamarlo antes de cambiar el nombre del hijo (se localiza por él)
+    void quitar(Nodo* hijo);
+
+    Nodo* buscar(string_view nombre) const {
+        Simbolo simbolo = TablaSimbolos::global().buscar(nombre);
+        if (simbolo == SIN_SIMBOLO) return nullptr; // Ningún nodo se llama así
+        for (const Entrada& e : recientes) {
+            if (e.simbolo == simbolo) return e.nodo;
+        }
+        // 'mv' admite hermanos con el mismo nombre: se salta las lápidas de ese nombre
+        for (size_t i = buscarOrdenada(nombre, simbolo); i < ordenadas.size() && ordenadas[i].simbolo == simbolo; ++i) {
+            if (ordenadas[i].nodo) return ordenadas[i].nodo;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Entrega los hijos a 'visitante' por orden de nombre, sin ordenar nada salvo las
+     *        altas que siguen en el búfer.
+     */
+    template <typename Visitante>
+    void recorrer(Visitante visitante) const {
+        vector<Entrada> pendientes(recientes);
+        std::sort(pendientes.begin(), pendientes.end(), menor);
+        auto r = pendientes.begin();
+        for (const Entrada& e : ordenadas) {
+            if (!e.nodo) continue;
+            for (; r != pendientes.end() && menor(*r, e); ++r) visitante(r->nodo);
+            visitante(e.nodo);
+        }
+        for (; r != pendientes.end(); ++r) visitante(r->nodo);
+    }
+
+    /**
+     * @brief Pone en 'resultado' los primeros 'limite' hijos (por nombre) cuyo nombre es mayor que
+     *        'despues'; devuelve true si quedan más.
+     * * Cuesta O(log n + limite log limite) más una pasada por el búfer de altas, O(sqrt n).
+     * * Una página no acaba entre dos hermanos con el mismo nombre: si el último se repite, entran todos.
+     */
+    bool pagina(string_view despues, size_t limite, vector<const Nodo*>& resultado) const {
+        // Del búfer basta ordenar las 'limite' primeras (y sus repetidas); las demás solo dicen si hay más
+        uint64_t c = claveDe(despues);
+        vector<Entrada> pendientes;
+        for (const Entrada& e : recientes) {
+            if (e.clave > c || (e.clave == c && texto(e) > despues)) pendientes.push_back(e);
+        }
+        if (limite == 0) { // Página vacía: solo se pregunta si queda alguno
+            if (!pendientes.empty()) return true;
+            for (size_t i = primeraMayor(despues); i < ordenadas.size(); ++i) {
+                if (ordenadas[i].nodo) return true;
+            }
+            return false;
+        }
+        size_t k = min(limite, pendientes.size());
+        std::partial_sort(pendientes.begin(), pendientes.begin() + k, pendientes.end(), menor);
+        auto fin = k ? std::partition(pendientes.begin() + k, pendientes.end(),
+                                      [&](const Entrada& e) { return e.simbolo == pendientes[k - 1].simbolo; })
+                     : pendientes.end();
+        bool resto = fin != pendientes.end();
+        pendientes.erase(fin, pendientes.end());
+        auto r = pendientes.begin();
+        size_t i = primeraMayor(despues);
+        const Entrada* ultima = nullptr;
+        while (true) {
+            while (i < ordenadas.size() && !ordenadas[i].nodo) ++i;
+            const Entrada* e;
+            if (r != pendientes.end() && (i == ordenadas.size() || menor(*r, ordenadas[i]))) e = &*r++;
+            else if (i < ordenadas.size()) e = &ordenadas[i++];
+            else return resto;
+            if (resultado.size() >= limite && (!ultima || e->simbolo != ultima->simbolo)) return true;
+            resultado.push_back(e->nodo);
+            ultima = e;
+        }
+    }
+
+    size_t tamano() const { return ordenadas.size() - lapidas + recientes.size(); }
+
+    size_t bytes() const {
+        return sizeof(IndiceHijos) + memoria::bytesVector(ordenadas) + memoria::bytesVector(recientes) +
+               memoria::bytesVector(eytzinger) + memoria::bytesVector(posicion);
+    }
+};
+
+/**
+ * @brief Tabla hash de los hijos de una carpeta (árboles con la política HijosHash).
+ * * Buscar un hijo es O(1) en promedio. Es un multimapa porque 'mv' admite hermanos con el mismo nombre.
+ */
+class TablaHijos {
+private:
+    unordered_multimap<Simbolo, Nodo*> tabla;
+
+public:
+    void construir(const ListaHijos& hijos);
+    void insertar(Nodo* hijo);
+    // Hay que llamarlo antes de cambiar el nombre del hijo (se localiza por él)
+    void quitar(Nodo* hijo);
+
+    Nodo* buscar(string_view nombre) const {
+        Simbolo simbolo = TablaSimbolos::global().buscar(nombre);
+        if (simbolo == SIN_SIMBOLO) return nullptr;
+        auto it = tabla.find(simbolo);
+        return it != tabla.end() ? it->second : nullptr;
+    }
+
+    // Nodos del multimapa (valor y dos punteros de enlace, más el hash guardado) y cubetas
+    size_t bytes() const {
+        return sizeof(TablaHijos) + tabla.size() * (sizeof(pair<const Simbolo, Nodo*>) + 2 * sizeof(void*)) +
+               tabla.bucket_count() * sizeof(void*);
+    }
+};
+
+/**
+ * @brief Reserva la parte caliente de los Nodo en bloques contiguos (ver Nodo::operator new).
+ * * Sin la cabecera y el redondeo de malloc cada Nodo ocupa sus 32 bytes justos, y los que se crean
+ *   seguidos quedan seguidos en memoria: un recorrido lee dos nodos por línea de caché. Los huecos
+ *   liberados se reutilizan (lista libre guardada en los propios huecos); los bloques no se devuelven.
+ * * Con candado: crean nodos varios hilos (importación) y los libera el hilo del Reclamador.
+ */
+class PoolNodos {
+private:
+    static constexpr size_t POR_BLOQUE = 4096; // Huecos por bloque (128 KiB con nodos de 32 bytes)
+
+    struct Hueco { Hueco* siguiente; };
+
+    mutex m;
+    Hueco* libres = nullptr;
+    vector<void*> bloques;
+    size_t tam_hueco = 0;
+    size_t sin_estrenar = 0; // Huecos aún no usados al final del último bloque
+    unsigned char* siguiente = nullptr;
+    size_t en_uso = 0;
+
+public:
+    // Nunca se destruye: el Reclamador libera nodos hasta el final del programa
+    static PoolNodos& global() {
+        static PoolNodos* pool = new PoolNodos();
+        return *pool;
+    }
+
+    void* reservar(size_t tam) {
+        lock_guard<mutex> candado(m);
+        ++en_uso;
+        if (libres) {
+            Hueco* hueco = libres;
+            libres = hueco->siguiente;
+            return hueco;
+        }
+        if (!sin_estrenar) {
+            tam_hueco = max(tam, sizeof(Hueco));
+            bloques.push_back(::operator new(POR_BLOQUE * tam_hueco));
+            siguiente = static_cast<unsigned char*>(bloques.back());
+            sin_estrenar = POR_BLOQUE;
+        }
+        --sin_estrenar;
+        void* hueco = siguiente;
+        siguiente += tam_hueco;
+        return hueco;
+    }
+
+    void liberar(void* p) {
+        lock_guard<mutex> candado(m);
+        --en_uso;
+        libres = new (p) Hueco{libres};
+    }
+
+    // Bytes reservados en bloques y nodos vivos
+    void medir(Consumo& c) {
+        lock_guard<mutex> candado(m);
+        c.bytes = bloques.size() * POR_BLOQUE * tam_hueco;
+        c.objetos = en_uso;
+    }
+};
+
+/**
+ * @brief Parte fría de un Nodo: lo que no se lee al resolver rutas ni al recorrer el árbol.
+ * * Aquí van también los metadatos que se añadan en el futuro, sin agrandar la parte caliente.
+ */
+struct DatosNodo {
+    string id;
+    // Solo en archivos con contenido. Nunca se modifica en sitio (se sustituye), así que una
+    // instantánea de guardado puede compartirlo sin copiarlo (ver guardado.hpp)
+    shared_ptr<const string> contenido;
+    uint64_t hash = 0;             // Hash Merkle del subárbol (válido si el nodo tiene hash_limpio)
+    unique_ptr<IndiceHijos> orden; // Solo en carpetas con 'sort on': los hijos por nombre
+    unique_ptr<TablaHijos> tabla;  // Solo en carpetas de árboles con la política HijosHash
+};
+
+/**
+ * @brief Representa un nodo en la jerarquía de archivos (Carpeta o Archivo).
+ * * Este nodo forma la base del árbol.
+ * * Separado en caliente y frío: el objeto (32 bytes, dos por línea de caché) guarda solo lo que tocan
+ *   la resolución de rutas y los recorridos (nombre, tipo, padre, hijos y unos indicadores); el id, el
+ *   contenido, el hash y los índices por carpeta están en DatosNodo, a un puntero de distancia.
+ */
+class Nodo {
+public:
+    Nombre nombre;     // Internado: comparar dos nombres es comparar dos enteros
+    TipoNodo tipo;
+    // Hash Merkle del subárbol (ver merkle.hpp). Se recalcula al pedirlo, solo si está pendiente;
+    // invariante: si un nodo está pendiente, todos sus ancestros también. Atómico porque obtenerHash
+    // lo rellena desde métodos const, que varios lectores pueden llamar a la vez (ArbolConcurrente)
+    mutable atomic<bool> hash_limpio{false};
+private:
+    // Si hay índice ordenado o tabla de hijos: así buscar un hijo no va a la parte fría sin necesidad
+    bool con_orden = false;
+    bool con_tabla = false;
+public:
+    Nodo* padre;
+    ListaHijos hijos;   // En orden de creación
+private:
+    unique_ptr<DatosNodo> frio;
+
+public:
+    // Constructor
+    Nodo(string n, TipoNodo t, string c = "")
+        : nombre(n), tipo(t), padre(nullptr), frio(make_unique<DatosNodo>()) {
+        frio->id = generarId(n);
+        fijarContenido(std::move(c));
+    }
+
+    string& id() { return frio->id; }
+    const string& id() const { return frio->id; }
+    const string& contenido() const {
+        static const string vacio;
+        return frio->contenido ? *frio->contenido : vacio;
+    }
+    const shared_ptr<const string>& contenidoCompartido() const { return frio->contenido; }
+    void fijarContenido(string c) {
+        if (c.empty()) frio->contenido.reset();
+        else frio->contenido = make_shared<const string>(std::move(c));
+    }
+    IndiceHijos* orden() const { return con_orden ? frio->orden.get() : nullptr; }
+    TablaHijos* tabla() const { return con_tabla ? frio->tabla.get() : nullptr; }
+
+    // La parte caliente sale de PoolNodos
+    static void* operator new(size_t tam) { return PoolNodos::global().reservar(tam); }
+    static void operator delete(void* p) { PoolNodos::global().liberar(p); }
+
+    // Generación de ID aleatorio basado en el nombre, tiempo y un generador Mersenne Twister
+    // (uno por hilo: la importación crea nodos desde varios hilos a la vez)
+    static string generarId(const string& nombre) {
+        thread_local std::mt19937 gen(std::random_device{}());
+        std::hash<std::string> hasheador;
+
+        size_t valor_hash = hasheador(nombre) ^ hasheador(std::to_string(time(0))) ^ gen();
+        return std::to_string(valor_hash);
+    }
+
+    // Destructor (libera los descendientes con una pila explícita: la profundidad no está acotada
+    // por la pila del hilo)
+    ~Nodo() {
+        vector<Nodo*> pila = hijos.soltar();
+        while (!pila.empty()) {
+            Nodo* nodo = pila.back();
+            pila.pop_back();
+            pila.insert(pila.end(), nodo->hijos.begin(), nodo->hijos.end());
+            nodo->hijos.clear(); // Así su destructor no desciende
+            delete nodo;
+        }
+    }
+
+    // Suma la memoria del subárbol: estructura (Nodo, parte fría, id, hijos) y contenidos por separado
+    void medirSubarbol(Consumo& nodos, Consumo& contenidos) const {
+        vector<const Nodo*> pila{this};
+        while (!pila.empty()) {
+            const Nodo* nodo = pila.back();
+            pila.pop_back();
+            nodos.bytes += sizeof(Nodo) + sizeof(DatosNodo) + memoria::bytesString(nodo->id()) + nodo->hijos.bytes();
+            if (nodo->orden()) nodos.bytes += nodo->orden()->bytes();
+            if (nodo->tabla()) nodos.bytes += nodo->tabla()->bytes();
+            ++nodos.objetos;
+            // make_shared: un solo bloque con el string, la vtabla y los dos contadores
+            const string* c = nodo->frio->contenido.get();
+            size_t bytes_contenido = c ? sizeof(string) + sizeof(void*) + 2 * sizeof(int) + memoria::bytesString(*c) : 0;
+            if (bytes_contenido) {
+                contenidos.bytes += bytes_contenido;
+                ++contenidos.objetos;
+            }
+            pila.insert(pila.end(), nodo->hijos.begin(), nodo->hijos.end());
+        }
+    }
+
+    // Marca pendiente el hash de este nodo y el de sus ancestros. Se detiene en el primero que ya lo
+    // estaba (por la invariante, los de encima también): cada mutación cuesta lo que suba hasta ahí.
+    void invalidarHash() {
+        // Solo con el árbol en exclusiva: no hay lectores a los que publicar nada
+        for (Nodo* n = this; n && n->hash_limpio.load(memory_order_relaxed); n = n->padre) {
+            n->hash_limpio.store(false, memory_order_relaxed);
+        }
+    }
+
+    // Da por bueno un hash ya conocido (por ejemplo, el guardado en una instantánea)
+    void fijarHash(uint64_t hash) const {
+        frio->hash = hash;
+        hash_limpio.store(true, memory_order_release);
+    }
+
+    // Hash del subárbol: O(1) si está limpio; si no, recalcula en postorden (sin recursión) solo los
+    // nodos pendientes y deja limpio todo el subárbol.
+    // Se puede llamar desde varios hilos con el árbol bajo candado compartido: el recálculo va con su
+    // propio mutex (dos lectores no rellenan el mismo nodo a la vez) y cada hash se publica con
+    // hash_limpio (release), así que la vía rápida no necesita candado.
+    uint64_t obtenerHash() const {
+        if (hash_limpio.load(memory_order_acquire)) return frio->hash;
+        static mutex mutex_recalculo;
+        lock_guard<mutex> candado(mutex_recalculo);
+        if (hash_limpio.load(memory_order_relaxed)) return frio->hash; // Lo completó otro lector
+        vector<pair<const Nodo*, bool>> pila{{this, false}}; // (nodo, hijos ya calculados)
+        while (!pila.empty()) {
+            auto [nodo, hijos_listos] = pila.back();
+            if (!hijos_listos) {
+                pila.back().second = true;
+                for (const Nodo* h : nodo->hijos) {
+                    if (!h->hash_limpio.load(memory_order_relaxed)) pila.emplace_back(h, false);
+                }
+                continue;
+            }
+            pila.pop_back();
+            uint64_t suma = 0;
+            for (const Nodo* h : nodo->hijos) suma += h->frio->hash;
+            nodo->frio->hash = merkle::hashNodo(nodo->nombre.vista(), nodo->tipo == TipoNodo::Carpeta, nodo->contenido(), suma);
+            nodo->hash_limpio.store(true, memory_order_release);
+        }
+        return frio->hash;
+    }
+
+    // Activa o quita el índice ordenado de los hijos
+    void ordenarHijos(bool activo) {
+        if (!activo) {
+            frio->orden.reset();
+        } else if (!frio->orden) {
+            frio->orden = make_unique<IndiceHijos>();
+            frio->orden->construir(hijos);
+        }
+        con_orden = activo;
+    }
+
+    // Activa o quita la tabla hash de los hijos (política HijosHash)
+    void tablaHijos(bool activa) {
+        if (!activa) {
+            frio->tabla.reset();
+        } else if (!frio->tabla) {
+            frio->tabla = make_unique<TablaHijos>();
+            frio->tabla->construir(hijos);
+        }
+        con_tabla = activa;
+    }
+
+    // true si este nodo es 'ancestro' o cuelga de él
+    bool estaDentroDe(const Nodo* ancestro) const {
+        for (const Nodo* actual = this; actual; actual = actual->padre) {
+            if (actual == ancestro) return true;
+        }
+        return false;
+    }
+
+    // Convierte el nodo (y sus hijos) a un objeto JSON
+    json aJson() const {
+        json j;
+        j["id"] = id();
+        j["nombre"] = nombre.str();
+        j["tipo"] = (tipo == TipoNodo::Carpeta ? "carpeta" : "archivo");
+        j["contenido"] = contenido();
+        j["hash"] = merkle::aTexto(obtenerHash());
+        if (orden()) j["ordenada"] = true;
+        json j_hijos = json::array();
+        for (const auto& hijo : hijos) {
+            j_hijos.push_back(hijo->aJson());
+        }
+        j["hijos"] = j_hijos;
+        return j;
+    }
+
+    // Crea un nodo (y sus hijos) a partir de un objeto JSON. Si se pasa 'hashes_guardados', se anotan
+    // en postorden los nodos que traían "hash" junto a ese valor, para verificarlos (ver cargar).
+    // Si el JSON falla a medias, lo ya creado se libera antes de relanzar.
+    static Nodo* desdeJson(const json& j, vector<pair<Nodo*, uint64_t>>* hashes_guardados = nullptr) {
+        TipoNodo tipo = (j["tipo"] == "carpeta" ? TipoNodo::Carpeta : TipoNodo::Archivo);
+        Nodo* nodo = new Nodo(j["nombre"], tipo, j.value("contenido", ""));
+        try {
+            nodo->id() = j["id"].get<string>();
+
+            if (j.contains("hijos")) {
+                for (const auto& j_hijo : j["hijos"]) {
+                    Nodo* hijo = desdeJson(j_hijo, hashes_guardados);
+                    hijo->padre = nodo;
+                    try {
+                        nodo->hijos.push_back(hijo);
+                    } catch (...) {
+                        delete hijo;
+                        throw;
+                    }
+                }
+            }
+            if (j.value("ordenada", false)) nodo->ordenarHijos(true);
+            uint64_t guardado;
+            if (hashes_guardados && j.contains("hash") && j["hash"].is_string() &&
+                merkle::desdeTexto(j["hash"].get<string>(), guardado)) {
+                hashes_guardados->emplace_back(nodo, guardado);
+            }
+        } catch (...) {
+            delete nodo; // Con los hijos ya colgados
+            throw;
+        }
+        return nodo;
+    }
+};
+
+static_assert(sizeof(Nodo) <= 32, "La parte caliente de Nodo debe caber en media línea de caché");
+
+inline void TablaHijos::construir(const ListaHijos& hijos) {
+    tabla.clear();
+    tabla.reserve(hijos.size());
+    for (Nodo* hijo : hijos) insertar(hijo);
+}
+
+inline void TablaHijos::insertar(Nodo* hijo) {
+    tabla.emplace(hijo->nombre.simbolo(), hijo);
+}
+
+inline void TablaHijos::quitar(Nodo* hijo) {
+    auto [desde, hasta] = tabla.equal_range(hijo->nombre.simbolo());
+    for (auto it = desde; it != hasta; ++it) {
+        if (it->second == hijo) {
+            tabla.erase(it);
+            return;
+        }
+    }
+}
+
+inline IndiceHijos::Entrada IndiceHijos::entradaDe(Nodo* hijo) {
+    return {claveDe(hijo->nombre.vista()), hijo, hijo->nombre.simbolo()};
+}
+
+inline void IndiceHijos::construir(const ListaHijos& hijos) {
+    ordenadas.clear();
+    recientes.clear();
+    lapidas = 0;
+    ordenadas.reserve(hijos.size());
+    for (Nodo* hijo : hijos) ordenadas.push_back(entradaDe(hijo));
+    std::sort(ordenadas.begin(), ordenadas.end(), menor);
+    construirEytzinger();
+}
+
+inline void IndiceHijos::quitar(Nodo* hijo) {
+    for (Entrada& e : recientes) {
+        if (e.nodo == hijo) {
+            e = recientes.back();
+            recientes.pop_back();
+            return;
+        }
+    }
+    Simbolo simbolo = hijo->nombre.simbolo();
+    for (size_t i = buscarOrdenada(hijo->nombre.vista(), simbolo); i < ordenadas.size() && ordenadas[i].simbolo == simbolo; ++i) {
+        if (ordenadas[i].nodo != hijo) continue; // Un hermano con el mismo nombre
+        ordenadas[i].nodo = nullptr;
+        if (++lapidas >= limite) fundir();
+        return;
+    }
+}
+
+// ==============================================
+// 1b. LIBERACIÓN DIFERIDA DE SUBÁRBOLES
+// ==============================================
+
+/**
+ * @brief Libera subárboles desvinculados en un hilo de fondo, para que 'clear_trash', 'load' o la
+ *        expulsión de la papelera no detengan la consola mientras se borran millones de nodos.
+ * * El hilo borra por tandas de TAM_TANDA nodos con una pila propia (sin recursión); entre tandas
+ *   suelta el candado, de modo que diferir() nunca espera a que termine un subárbol grande.
+ * * El hilo se crea con el primer subárbol diferido y se detiene (tras vaciar la cola) al destruir
+ *   el reclamador, al final del programa.
+ */
+class Reclamador {
+private:
+    static constexpr size_t TAM_TANDA = 4096;
+
+    mutex m;
+    condition_variable hay_trabajo;
+    condition_variable sin_trabajo;
+    deque<Nodo*> cola;        // Subárboles completos pendientes
+    vector<Nodo*> pila;       // Nodos del subárbol en curso (solo la toca el hilo)
+    bool ocupado = false;     // El hilo tiene una tanda entre manos
+    bool parar = false;
+    size_t subarboles_liberados = 0;
+    size_t nodos_liberados = 0;
+    thread hilo;
+
+    Reclamador() = default;
+
+    // Borra hasta TAM_TANDA nodos de la pila; devuelve cuántos
+    size_t liberarTanda() {
+        size_t n = 0;
+        while (!pila.empty() && n < TAM_TANDA) {
+            Nodo* nodo = pila.back();
+            pila.pop_back();
+            pila.insert(pila.end(), nodo->hijos.begin(), nodo->hijos.end());
+            nodo->hijos.clear();
+            delete nodo;
+            ++n;
+        }
+        return n;
+    }
+
+    void bucle() {
+        unique_lock<mutex> candado(m);
+        while (true) {
+            hay_trabajo.wait(candado, [&] { return parar || !cola.empty() || !pila.empty(); });
+            if (pila.empty()) {
+                if (cola.empty()) break; // parar y nada pendiente
+                pila.push_back(cola.front());
+                cola.pop_front();
+            }
+            ocupado = true;
+            candado.unlock();
+            size_t n = liberarTanda();
+            bool terminado = pila.empty();
+            candado.lock();
+            ocupado = false;
+            nodos_liberados += n;
+            if (terminado) ++subarboles_liberados;
+            if (cola.empty() && pila.empty()) sin_trabajo.notify_all();
+        }
+    }
+
+public:
+    Reclamador(const Reclamador&) = delete;
+    Reclamador& operator=(const Reclamador&) = delete;
+
+    static Reclamador& global() {
+        static Reclamador instancia;
+        return instancia;
+    }
+
+    ~Reclamador() {
+        {
+            lock_guard<mutex> candado(m);
+            parar = true;
+        }
+        hay_trabajo.notify_one();
+        if (hilo.joinable()) hilo.join();
+    }
+
+    /**
+     * @brief Entrega un subárbol ya desvinculado (nadie más debe apuntar a él) para liberarlo en segundo plano.
+     */
+    void diferir(Nodo* subarbol) {
+        if (!subarbol) return;
+        {
+            lock_guard<mutex> candado(m);
+            cola.push_back(subarbol);
+            if (!hilo.joinable()) hilo = thread(&Reclamador::bucle, this);
+        }
+        hay_trabajo.notify_one();
+    }
+
+    /**
+     * @brief Espera a que se haya liberado todo lo diferido hasta ahora (útil para medir memoria).
+     */
+    void esperar() {
+        unique_lock<mutex> candado(m);
+        sin_trabajo.wait(candado, [&] { return cola.empty() && pila.empty() && !ocupado; });
+    }
+
+    size_t pendientes() {
+        lock_guard<mutex> candado(m);
+        return cola.size() + (pila.empty() ? 0 : 1);
+    }
+
+    size_t nodosLiberados() {
+        lock_guard<mutex> candado(m);
+        return nodos_liberados;
+    }
+
+    /**
+     * @brief true si al terminar el proceso se puede omitir la liberación de toda la memoria
+     *        (el sistema la recupera de golpe).
+     * * No lo es con los sanitizadores, cuyo detector de fugas daría falsos positivos, ni si se
+     *   pide expresamente con la variable de entorno PROYECTOARBOL_LIBERAR_AL_SALIR.
+     */
+    static bool salidaRapidaSegura() {
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+        return false;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+        return false;
+#endif
+#endif
+        return getenv("PROYECTOARBOL_LIBERAR_AL_SALIR") == nullptr;
+    }
+};
+
+// ==============================================
+// 2. ESTRUCTURA AUXILIAR: Trie para Autocompletado
+// ==============================================
+
+/**
+ * @brief Nodo de la estructura de datos Trie (o Prefixtree).
+ */
+class NodoTrie {
+public:
+    map<char, NodoTrie*> hijos;
+    bool esFinDePalabra;
+    vector<Simbolo> nombres_completos; // Para manejar duplicados o nombres completos
+
+    NodoTrie() : esFinDePalabra(false) {}
+    ~NodoTrie() {
+        for (auto const& [clave, valor] : hijos) delete valor;
+    }
+};
+
+/**
+ * @brief Implementación de la estructura Trie para búsqueda por prefijo (autocompletado).
+ */
+class Trie {
+private:
+    NodoTrie* raiz;
+
+    // Función auxiliar recursiva para encontrar todas las palabras desde un nodo
+    void encontrarTodasLasPalabras(NodoTrie* nodo, vector<string>& resultados) {
+        if (nodo->esFinDePalabra) {
+            for (Simbolo s : nodo->nombres_completos) resultados.emplace_back(TablaSimbolos::global().texto(s));
+        }
+        for (auto const& [clave, hijo] : nodo->hijos) {
+            encontrarTodasLasPalabras(hijo, resultados);
+        }
+    }
+
+    // Igual que encontrarTodasLasPalabras, pero entrega cada nombre al visitante sin copiarlo
+    template <typename Visitante>
+    static void visitarPalabras(const NodoTrie* nodo, Visitante& visitante) {
+        if (nodo->esFinDePalabra) {
+            for (Simbolo s : nodo->nombres_completos) visitante(TablaSimbolos::global().texto(s));
+        }
+        for (auto const& [clave, hijo] : nodo->hijos) {
+            visitarPalabras(hijo, visitante);
+        }
+    }
+
+    // Desciende por el Trie siguiendo el prefijo; nullptr si no hay coincidencias
+    const NodoTrie* descender(string_view prefijo) const {
+        const NodoTrie* actual = raiz;
+        for (char c : prefijo) {
+            auto it = actual->hijos.find(c);
+            if (it == actual->hijos.end()) return nullptr;
+            actual = it->second;
+        }
+        return actual;
+    }
+
+public:
+    Trie() { raiz = new NodoTrie(); }
+    ~Trie() { delete raiz; }
+
+    // Reinicia y reconstruye el Trie a partir del árbol de jerarquía
+    void reiniciarYConstruir(Nodo* raiz_arbol) {
+        delete raiz;
+        raiz = new NodoTrie();
+        asistenteConstruirTrie(raiz_arbol);
+    }
+
+    // Función auxiliar recursiva para construir el Trie
+    void asistenteConstruirTrie(Nodo* nodo) {
+        if (!nodo) return;
+        // La raíz del sistema de archivos ("/") no se indexa para búsqueda
+        if (nodo->nombre != "/") {
+            insertarPalabra(nodo->nombre);
+        }
+        for (Nodo* hijo : nodo->hijos) {
+            asistenteConstruirTrie(hijo);
+        }
+    }
+
+    // Inserta una palabra (nombre de nodo) en el Trie
+    void insertarPalabra(Nombre palabra) {
+        NodoTrie* actual = raiz;
+        for (char c : palabra.vista()) {
+            if (actual->hijos.find(c) == actual->hijos.end()) {
+                actual->hijos[c] = new NodoTrie();
+            }
+            actual = actual->hijos[c];
+        }
+        actual->esFinDePalabra = true;
+
+        // Agregar el nombre completo para manejar posibles duplicados de nombres
+        if (std::find(actual->nombres_completos.begin(), actual->nombres_completos.end(), palabra.simbolo()) == actual->nombres_completos.end()) {
+             actual->nombres_completos.push_back(palabra.simbolo());
+        }
+    }
+
+    /**
+     * @brief Inserta muchas palabras de una vez: se ordenan y cada una reutiliza el camino del
+     *        Trie que comparte con la anterior, en lugar de descender siempre desde la raíz.
+     */
+    void insertarLote(vector<Nombre>& nombres) {
+        std::sort(nombres.begin(), nombres.end(), [](Nombre a, Nombre b) { return a.vista() < b.vista(); });
+        nombres.erase(std::unique(nombres.begin(), nombres.end()), nombres.end());
+
+        vector<NodoTrie*> camino{raiz}; // camino[i] = nodo tras los i primeros caracteres de 'anterior'
+        string_view anterior;
+        for (Nombre nombre : nombres) {
+            string_view palabra = nombre.vista();
+            size_t comun = 0;
+            size_t limite = min(anterior.size(), palabra.size());
+            while (comun < limite && anterior[comun] == palabra[comun]) ++comun;
+            camino.resize(comun + 1);
+
+            NodoTrie* actual = camino.back();
+            for (size_t i = comun; i < palabra.size(); ++i) {
+                NodoTrie*& siguiente = actual->hijos[palabra[i]];
+                if (!siguiente) siguiente = new NodoTrie();
+                actual = siguiente;
+                camino.push_back(actual);
+            }
+            actual->esFinDePalabra = true;
+            if (std::find(actual->nombres_completos.begin(), actual->nombres_completos.end(), nombre.simbolo()) == actual->nombres_completos.end()) {
+                actual->nombres_completos.push_back(nombre.simbolo());
+            }
+            anterior = palabra;
+        }
+    }
+
+    // Realiza la búsqueda por prefijo y autocompleta
+    vector<string> autocompletar(const string& prefijo) {
+        NodoTrie* actual = raiz;
+        vector<string> resultados;
+
+        // Recorrer hasta el final del prefijo
+        for (char c : prefijo) {
+            if (actual->hijos.find(c) == actual->hijos.end()) {
+                return resultados; // No hay coincidencias
+            }
+            actual = actual->hijos[c];
+        }
+
+        // Encontrar todas las palabras completas desde este punto
+        encontrarTodasLasPalabras(actual, resultados);
+
+        // Limpiar duplicados y ordenar los resultados
+        std::sort(resultados.begin(), resultados.end());
+        resultados.erase(std::unique(resultados.begin(), resultados.end()), resultados.end());
+
+        return resultados;
+    }
+
+    /**
+     * @brief Suma la memoria de los NodoTrie (objeto y mapa de hijos) y, aparte, la de sus nombres_completos.
+     */
+    void medirMemoria(Consumo& nodos, Consumo& nombres) const {
+        vector<const NodoTrie*> pila{raiz};
+        while (!pila.empty()) {
+            const NodoTrie* nodo = pila.back();
+            pila.pop_back();
+            nodos.bytes += sizeof(NodoTrie) + memoria::bytesNodosMapa(nodo->hijos);
+            ++nodos.objetos;
+            nombres.bytes += memoria::bytesVector(nodo->nombres_completos);
+            nombres.objetos += nodo->nombres_completos.size();
+            for (auto const& [clave, hijo] : nodo->hijos) pila.push_back(hijo);
+        }
+    }
+
+    /**
+     * @brief Recorre los nombres que empiezan por el prefijo sin reservar memoria.
+     * * El orden es el del Trie (lexicográfico por carácter); no se eliminan duplicados entre nodos.
+     */
+    template <typename Visitante>
+    void visitarPrefijo(string_view prefijo, Visitante visitante) const {
+        const NodoTrie* inicio = descender(prefijo);
+        if (inicio) visitarPalabras(inicio, visitante);
+    }
+};
+
+// ==============================================
+// 2b. ESTRUCTURA AUXILIAR: Papelera de reciclaje
+// ==============================================
+
+/**
+ * @brief Un subárbol borrado, con lo necesario para devolverlo a su sitio.
+ */
+struct EntradaPapelera {
+    Nodo* nodo = nullptr;           // Raíz del subárbol desvinculado (propiedad de la papelera)
+    Nodo* padre_original = nullptr; // nullptr si esa carpeta ya se liberó: entonces se usa ruta_padre
+    string ruta_padre;              // Ruta de la carpeta original en el momento del borrado
+    size_t posicion = 0;            // Lugar que ocupaba entre los hijos de esa carpeta
+    size_t bytes = 0;               // Memoria del subárbol (estructura y contenidos)
+    size_t nodos = 0;
+};
+
+/**
+ * @brief Papelera restaurable con límite de memoria.
+ * * Cada entrada recibe un identificador creciente, que es el que muestra 'papelera' y usa
+ *   'restore': el menor es siempre el más antiguo y el primero en expulsarse cuando los bytes
+ *   superan el límite (0 = sin límite).
+ * * Al liberar un subárbol, las entradas cuya carpeta original estaba dentro de él pierden ese
+ *   puntero y pasan a restaurarse por ruta; así nunca queda un puntero colgante.
+ */
+class Papelera {
+private:
+    map<size_t, EntradaPapelera> entradas;
+    size_t siguiente_id = 0;
+    size_t bytes_totales = 0;
+    size_t limite;
+
+    void liberar(map<size_t, EntradaPapelera>::iterator it) {
+        Nodo* subarbol = it->second.nodo;
+        bytes_totales -= it->second.bytes;
+        entradas.erase(it);
+        olvidarPadresEn(subarbol);
+        Reclamador::global().diferir(subarbol);
+    }
+
+public:
+    static constexpr size_t LIMITE_POR_DEFECTO = size_t(64) * 1024 * 1024;
+
+    explicit Papelera(size_t limite_bytes = LIMITE_POR_DEFECTO) : limite(limite_bytes) {}
+    Papelera(const Papelera&) = delete;
+    Papelera& operator=(const Papelera&) = delete;
+    ~Papelera() { vaciar(); }
+
+    /**
+     * @brief Guarda un subárbol ya desvinculado; devuelve su identificador.
+     */
+    size_t agregar(Nodo* nodo, Nodo* padre, size_t posicion, string ruta_padre) {
+        EntradaPapelera e;
+        e.nodo = nodo;
+        e.padre_original = padre;
+        e.ruta_padre = std::move(ruta_padre);
+        e.posicion = posicion;
+        Consumo estructura, contenidos;
+        nodo->medirSubarbol(estructura, contenidos);
+        e.bytes = estructura.bytes + contenidos.bytes;
+        e.nodos = estructura.objetos;
+        bytes_totales += e.bytes;
+        entradas.emplace(siguiente_id, std::move(e));
+        return siguiente_id++;
+    }
+
+    /**
+     * @brief Saca una entrada sin liberarla (para restaurarla); false si no existe.
+     */
+    bool extraer(size_t id, EntradaPapelera& salida) {
+        auto it = entradas.find(id);
+        if (it == entradas.end()) return false;
+        salida = std::move(it->second);
+        bytes_totales -= salida.bytes;
+        entradas.erase(it);
+        return true;
+    }
+
+    // Devuelve una entrada extraída cuya restauración falló (conserva su identificador)
+    void devolver(size_t id, EntradaPapelera e) {
+        bytes_totales += e.bytes;
+        entradas.emplace(id, std::move(e));
+    }
+
+    /**
+     * @brief Libera las entradas más antiguas hasta respetar el límite; devuelve cuántas liberó.
+     */
+    size_t aplicarLimite() {
+        size_t liberadas = 0;
+        while (limite > 0 && bytes_totales > limite && !entradas.empty()) {
+            liberar(entradas.begin());
+            ++liberadas;
+        }
+        return liberadas;
+    }
+
+    // Libera todo (en segundo plano); devuelve cuántas entradas había
+    size_t vaciar() {
+        size_t n = entradas.size();
+        for (auto& [id, e] : entradas) Reclamador::global().diferir(e.nodo);
+        entradas.clear();
+        bytes_totales = 0;
+        return n;
+    }
+
+    /**
+     * @brief Olvida los punteros a carpetas originales que están dentro de un subárbol que se va a liberar.
+     */
+    void olvidarPadresEn(const Nodo* subarbol) {
+        for (auto& [id, e] : entradas) {
+            if (e.padre_original && e.padre_original->estaDentroDe(subarbol)) e.padre_original = nullptr;
+        }
+    }
+
+    // Entrada con ese identificador, o nullptr
+    const EntradaPapelera* buscar(size_t id) const {
+        auto it = entradas.find(id);
+        return it == entradas.end() ? nullptr : &it->second;
+    }
+
+    void fijarLimite(size_t bytes) { limite = bytes; }
+    size_t limiteBytes() const { return limite; }
+    size_t bytes() const { return bytes_totales; }
+    size_t tamano() const { return entradas.size(); }
+    bool vacia() const { return entradas.empty(); }
+    const map<size_t, EntradaPapelera>& contenido() const { return entradas; }
+
+    void medirMemoria(Consumo& c) const {
+        c.bytes += memoria::bytesNodosMapa(entradas);
+        Consumo contenidos;
+        for (const auto& [id, e] : entradas) {
+            e.nodo->medirSubarbol(c, contenidos);
+            c.bytes += memoria::bytesString(e.ruta_padre);
+        }
+        c.bytes += contenidos.bytes;
+    }
+};
+
+// ==============================================
+// 2c. ESTRUCTURA AUXILIAR: Historial para deshacer/rehacer
+// ==============================================
+
+enum class TipoOperacion : uint8_t { Crear, Mover, Renombrar, Eliminar };
+
+/**
+ * @brief Una operación del historial (32 bytes): se guarda lo justo para invertirla, apuntando a
+ *        los nodos directamente (no por ruta).
+ * * Al deshacerla o rehacerla se reescribe con los datos de la inversa y pasa a la otra pila.
+ */
+struct OperacionHistorial {
+    Nodo* nodo;     // Nodo creado, movido, renombrado o eliminado
+    Nodo* padre;    // Crear/Eliminar: su carpeta. Mover: la carpeta a la que hay que devolverlo
+    uint64_t dato;  // Crear/Mover: posición entre los hijos. Renombrar: símbolo del otro nombre.
+                    // Eliminar: identificador en la papelera
+    TipoOperacion tipo;
+    bool con_anterior = false; // Se deshace y rehace junto con la anterior (un 'import tar' de varias entradas)
+};
+
+/**
+ * @brief Pilas de deshacer (acotada a 'profundidad' operaciones, se olvidan las más antiguas) y
+ *        de rehacer (se descarta con cualquier otra modificación del árbol).
+ * * Un nodo creado y luego deshecho queda desvinculado y es propiedad del historial mientras su
+ *   operación esté en la pila de rehacer; al descartarla se entrega al Reclamador.
+ */
+class Historial {
+private:
+    deque<OperacionHistorial> deshacer;
+    vector<OperacionHistorial> rehacer;
+    size_t profundidad;
+
+public:
+    static constexpr size_t PROFUNDIDAD_POR_DEFECTO = 1000;
+
+    explicit Historial(size_t max_operaciones = PROFUNDIDAD_POR_DEFECTO) : profundidad(max_operaciones) {}
+    Historial(const Historial&) = delete;
+    Historial& operator=(const Historial&) = delete;
+    ~Historial() { vaciar(); }
+
+    // Una modificación nueva: invalida lo que se podía rehacer
+    void registrar(const OperacionHistorial& op) {
+        descartarRehacer();
+        apilarDeshacer(op);
+    }
+
+    // Tras rehacer una operación (no toca la pila de rehacer)
+    void apilarDeshacer(const OperacionHistorial& op) {
+        if (profundidad == 0) return;
+        deshacer.push_back(op);
+        while (deshacer.size() > profundidad) deshacer.pop_front();
+    }
+
+    void apilarRehacer(const OperacionHistorial& op) { rehacer.push_back(op); }
+
+    // La siguiente operación por rehacer va con la que se acaba de rehacer
+    bool rehacerEncadenada() const { return !rehacer.empty() && rehacer.back().con_anterior; }
+
+    bool sacarDeshacer(OperacionHistorial& op) {
+        if (deshacer.empty()) return false;
+        op = deshacer.back();
+        deshacer.pop_back();
+        return true;
+    }
+
+    bool sacarRehacer(OperacionHistorial& op) {
+        if (rehacer.empty()) return false;
+        op = rehacer.back();
+        rehacer.pop_back();
+        return true;
+    }
+
+    void descartarRehacer() {
+        for (const OperacionHistorial& op : rehacer) {
+            if (op.tipo == TipoOperacion::Crear) Reclamador::global().diferir(op.nodo);
+        }
+        rehacer.clear();
+    }
+
+    void vaciar() {
+        descartarRehacer();
+        deshacer.clear();
+    }
+
+    void fijarProfundidad(size_t n) {
+        profundidad = n;
+        while (deshacer.size() > profundidad) deshacer.pop_front();
+    }
+
+    size_t profundidadMaxima() const { return profundidad; }
+    size_t operacionesDeshacer() const { return deshacer.size(); }
+    size_t operacionesRehacer() const { return rehacer.size(); }
+
+    // Las operaciones, más los subárboles desvinculados que conserva la pila de rehacer
+    void medirMemoria(Consumo& c) const {
+        c.bytes += deshacer.size() * sizeof(OperacionHistorial) + memoria::bytesVector(rehacer);
+        c.objetos += deshacer.size() + rehacer.size();
+        Consumo nodos, contenidos;
+        for (const OperacionHistorial& op : rehacer) {
+            if (op.tipo == TipoOperacion::Crear) op.nodo->medirSubarbol(nodos, contenidos);
+        }
+        c.bytes += nodos.bytes + contenidos.bytes;
+    }
+};
+
+// ==============================================
+// 2d. POLÍTICAS DEL ÁRBOL (parámetros de ArbolConPoliticas)
+// ==============================================
+//
+// Cada política es un tipo que se elige al compilar: cada combinación genera su propio código y las
+// llamadas se resuelven (y normalmente se expanden en línea) sin funciones virtuales.
+//
+// Índice de los hijos de cada carpeta (cuánto cuesta encontrar un hijo por nombre):
+//   HijosLineales     se recorren comparando símbolos; sin memoria extra ('sort on' sigue disponible)
+//   HijosOrdenados    toda carpeta con IndiceHijos: O(log n) y 'ls --sorted' sin ordenar
+//   HijosHash         toda carpeta con TablaHijos: O(1) en promedio, la opción que más memoria usa
+// Índices globales por nombre (cuánto cuestan 'search' y cada alta):
+//   IndicesNinguno    ninguno: 'search' recorre el árbol y las altas no mantienen nada
+//   IndicesExacto     solo el mapa de búsqueda exacta; el prefijo recorre el árbol
+//   IndicesCompletos  mapa exacto y Trie de prefijos (ArbolJerarquia)
+
+struct HijosLineales {
+    static constexpr bool POR_CARPETA = false; // No hay nada que preparar en cada carpeta
+    static void preparar(Nodo*) {}
+};
+
+struct HijosOrdenados {
+    static constexpr bool POR_CARPETA = true;
+    static void preparar(Nodo* carpeta) { carpeta->ordenarHijos(true); }
+};
+
+struct HijosHash {
+    static constexpr bool POR_CARPETA = true;
+    static void preparar(Nodo* carpeta) { carpeta->tablaHijos(true); }
+};
+
+class IndicesNinguno {
+public:
+    static constexpr bool EXACTO = false;
+    static constexpr bool PREFIJO = false;
+
+    void reconstruir(Nodo*) {}
+    void alta(Nodo*) {}
+    void altaLote(const vector<Nodo*>&) {}
+    void medirMemoria(ReporteMemoria&) const {}
+};
+
+class IndicesExacto {
+private:
+    map<Simbolo, Nodo*> mapa; // Por símbolo internado; con nombres repetidos, el último indexado
+
+    // En preorden, como siempre: con nombres repetidos gana el último
+    void indexar(Nodo* nodo) {
+        mapa[nodo->nombre.simbolo()] = nodo;
+        for (Nodo* hijo : nodo->hijos) indexar(hijo);
+    }
+
+public:
+    static constexpr bool EXACTO = true;
+    static constexpr bool PREFIJO = false;
+
+    void reconstruir(Nodo* raiz) {
+        mapa.clear();
+        for (Nodo* hijo : raiz->hijos) indexar(hijo); // La raíz no se indexa
+    }
+
+    void alta(Nodo* nodo) {
+        if (nodo->nombre != "/") mapa[nodo->nombre.simbolo()] = nodo;
+    }
+
+    void altaLote(const vector<Nodo*>& nodos) {
+        for (Nodo* nodo : nodos) alta(nodo);
+    }
+
+    Nodo* buscar(Simbolo simbolo) const {
+        auto it = mapa.find(simbolo);
+        return it != mapa.end() ? it->second : nullptr;
+    }
+
+    void medirMemoria(ReporteMemoria& r) const {
+        r.mapa_exacto.objetos = mapa.size();
+        r.mapa_exacto.bytes = memoria::bytesNodosMapa(mapa);
+    }
+};
+
+class IndicesCompletos : public IndicesExacto {
+private:
+    Trie trie;
+
+public:
+    static constexpr bool PREFIJO = true;
+
+    void reconstruir(Nodo* raiz) {
+        IndicesExacto::reconstruir(raiz);
+        trie.reiniciarYConstruir(raiz);
+    }
+
+    void alta(Nodo* nodo) {
+        IndicesExacto::alta(nodo);
+        trie.insertarPalabra(nodo->nombre);
+    }
+
+    // Los nombres van al Trie ordenados, compartiendo el camino con el anterior (ver Trie::insertarLote)
+    void altaLote(const vector<Nodo*>& nodos) {
+        IndicesExacto::altaLote(nodos);
+        vector<Nombre> nombres;
+        nombres.reserve(nodos.size());
+        for (const Nodo* nodo : nodos) nombres.push_back(nodo->nombre);
+        trie.insertarLote(nombres);
+    }
+
+    vector<string> autocompletar(const string& prefijo) { return trie.autocompletar(prefijo); }
+
+    template <typename Visitante>
+    void visitarPrefijo(string_view prefijo, Visitante visitante) const {
+        trie.visitarPrefijo(prefijo, visitante);
+    }
+
+    void medirMemoria(ReporteMemoria& r) const {
+        IndicesExacto::medirMemoria(r);
+        trie.medirMemoria(r.trie, r.nombres_trie);
+    }
+};
+
+// ==============================================
+// 3. ESTRUCTURA PRINCIPAL: ArbolJerarquia
+// ==============================================
+
+/**
+ * @brief Una entrada de creación masiva (ver ArbolJerarquia::crearNodos).
+ */
+struct EntradaNodo {
+    string ruta;      // Ruta completa del nodo a crear (ej: "/docs/2024/informe.txt")
+    TipoNodo tipo;
+    string contenido; // Solo relevante para archivos
+};
+
+/**
+ * @brief Escribe 'j' en 'ruta' con el formato de 'save' pasando por un temporal y rename(): quien
+ *        abra el archivo ve el anterior o el nuevo completo, nunca uno a medias.
+ * * Lanza runtime_error si no puede escribir (el temporal se borra).
+ * @return Los bytes escritos.
+ */
+inline size_t escribirJsonAtomico(const json& j, const string& ruta) {
+    string temporal = ruta + ".tmp";
+    size_t bytes;
+    {
+        ofstream o(temporal, ios::trunc);
+        if (!o.is_open()) throw runtime_error("no se puede crear " + temporal);
+        o << setw(4) << j << endl;
+        bytes = size_t(o.tellp());
+        o.close();
+        if (o.fail()) {
+            std::remove(temporal.c_str());
+            throw runtime_error("fallo al escribir " + temporal);
+        }
+    }
+    if (std::rename(temporal.c_str(), ruta.c_str()) != 0) {
+        std::remove(temporal.c_str());
+        throw runtime_error("no se puede renombrar " + temporal + " a " + ruta);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Clase principal que gestiona la estructura de árbol de jerarquía de archivos/carpetas.
+ * * Incluye índices de búsqueda (Trie para prefijo, Map para exacto) para un acceso rápido.
+ * * Es una plantilla sobre dos políticas (ver la sección 2d): el índice de los hijos de cada carpeta
+ *   y los índices globales por nombre. ArbolJerarquia es la combinación de siempre; otras
+ *   instancias sirven para árboles pequeños (sin índices) o muy anchos (hijos en tabla hash).
+ */
+template <typename PoliticaHijos, typename PoliticaIndices>
+class ArbolConPoliticas {
+private:
+    Nodo* raiz;
+    PoliticaIndices indices;
+    int nivel_lote = 0;            // > 0 mientras hay un lote de escrituras abierto
+    bool indices_pendientes = false; // Reconstrucción aplazada hasta cerrar el lote
+    ostream* salida = &cout;         // Resultados de consultas (listados)
+    ostream* avisos = &cout;         // Confirmaciones de cada operación ("Carpeta 'x' creado en ...")
+    ostream* errores = &cerr;        // Mensajes de error y advertencias
+    bool silencioso = false;         // Si es true, las confirmaciones se descartan
+    Papelera papelera;               // Subárboles borrados con 'rm', restaurables con 'restore'
+    Historial historial;             // Operaciones para 'undo' / 'redo'
+
+    // Flujo sin buffer: toda escritura falla en el centinela y no cuesta formatear nada
+    static ostream& flujoNulo() {
+        static ostream nulo(nullptr);
+        return nulo;
+    }
+
+    // --- Funciones Auxiliares Privadas ---
+
+    // Encuentra un nodo dado su ruta completa (ej: "/docs/reporte.txt")
+    // Los segmentos se comparan como string_view sobre la ruta original: no se reserva memoria.
+    Nodo* encontrarNodoPorRuta(string_view ruta) const {
+        MedidaMuestreada medida(Fase::ResolucionRuta); // Se llama en cada lectura: solo se muestrea
+        Nodo* actual = raiz;
+        size_t i = 0;
+
+        // Recorrer la ruta, segmento por segmento
+        while (i < ruta.size()) {
+            if (ruta[i] == '/') { ++i; continue; } // Separadores iniciales o repetidos
+            size_t fin = ruta.find('/', i);
+            if (fin == string_view::npos) fin = ruta.size();
+
+            // Un segmento que nunca se internó no puede existir; si no, se compara como entero
+            Nodo* siguiente = hijoConNombre(actual, ruta.substr(i, fin - i));
+            if (!siguiente) return nullptr; // Segmento de ruta no existe
+            actual = siguiente;
+            i = fin;
+        }
+        return actual;
+    }
+
+    // Hijo directo con ese nombre (comparando símbolos, o en el índice de la carpeta si lo hay), o nullptr
+    static Nodo* hijoConNombre(const Nodo* padre, string_view nombre) {
+        if (TablaHijos* tabla = padre->tabla()) return tabla->buscar(nombre);
+        if (IndiceHijos* orden = padre->orden()) return orden->buscar(nombre);
+        Simbolo buscado = TablaSimbolos::global().buscar(nombre);
+        if (buscado == SIN_SIMBOLO) return nullptr;
+        for (Nodo* hijo : padre->hijos) {
+            if (hijo->nombre.simbolo() == buscado) return hijo;
+        }
+        return nullptr;
+    }
+
+    // Una línea de 'ls'
+    static void mostrarHijo(ostream& out, const Nodo* hijo) {
+        out << (hijo->tipo == TipoNodo::Carpeta ? "[DIR] " : "[FIL] ") << hijo->nombre << '\n';
+    }
+
+    // Devuelve el siguiente segmento no vacío de la ruta a partir de i (vacío si no quedan)
+    static string_view siguienteSegmento(string_view ruta, size_t& i) {
+        while (i < ruta.size() && ruta[i] == '/') ++i;
+        size_t inicio = i;
+        while (i < ruta.size() && ruta[i] != '/') ++i;
+        return ruta.substr(inicio, i - inicio);
+    }
+
+    // Crea un hijo sin comprobar duplicados ni tocar los índices (quien llama se encarga)
+    static Nodo* anexarHijo(Nodo* padre, string_view nombre, TipoNodo tipo, string_view contenido = {}) {
+        Nodo* nuevoNodo = new Nodo(string(nombre), tipo, string(contenido));
+        if (tipo == TipoNodo::Carpeta) PoliticaHijos::preparar(nuevoNodo);
+        nuevoNodo->padre = padre;
+        padre->hijos.push_back(nuevoNodo);
+        if (padre->orden()) padre->orden()->insertar(nuevoNodo);
+        if (padre->tabla()) padre->tabla()->insertar(nuevoNodo);
+        padre->invalidarHash();
+        return nuevoNodo;
+    }
+
+    // Quita 'nodo' de los hijos de su padre; devuelve la posición que ocupaba
+    static size_t desvincular(Nodo* nodo) {
+        nodo->padre->invalidarHash();
+        if (nodo->padre->orden()) nodo->padre->orden()->quitar(nodo);
+        if (nodo->padre->tabla()) nodo->padre->tabla()->quitar(nodo);
+        auto& hijos = nodo->padre->hijos;
+        size_t posicion = size_t(std::find(hijos.begin(), hijos.end(), nodo) - hijos.begin());
+        hijos.erase(hijos.begin() + posicion);
+        nodo->padre = nullptr;
+        return posicion;
+    }
+
+    // Cuelga 'nodo' de 'padre' en 'posicion' (al final si ya no hay tantos hijos)
+    static void vincular(Nodo* nodo, Nodo* padre, size_t posicion) {
+        auto& hijos = padre->hijos;
+        hijos.insert(hijos.begin() + min(posicion, hijos.size()), nodo);
+        nodo->padre = padre;
+        if (padre->orden()) padre->orden()->insertar(nodo);
+        if (padre->tabla()) padre->tabla()->insertar(nodo);
+        padre->invalidarHash();
+    }
+
+    // Cambia el nombre de un nodo manteniendo el índice ordenado de su padre y los hashes
+    static void cambiarNombre(Nodo* nodo, string_view nombre) {
+        IndiceHijos* orden = nodo->padre ? nodo->padre->orden() : nullptr;
+        TablaHijos* tabla = nodo->padre ? nodo->padre->tabla() : nullptr;
+        if (orden) orden->quitar(nodo);
+        if (tabla) tabla->quitar(nodo);
+        nodo->nombre = nombre;
+        if (orden) orden->insertar(nodo);
+        if (tabla) tabla->insertar(nodo);
+        nodo->invalidarHash();
+    }
+
+    // Recalcula los hashes del árbol recién cargado y los compara con los guardados en el archivo.
+    // Un nodo alterado descuadra también a todos sus ancestros; en postorden, el primer descuadre no
+    // tiene descendientes descuadrados: es el origen que se informa.
+    void verificarHashes(const vector<pair<Nodo*, uint64_t>>& guardados, const string& nombre_archivo) const {
+        raiz->obtenerHash();
+        const Nodo* primero = nullptr;
+        size_t distintos = 0;
+        for (const auto& [nodo, hash] : guardados) {
+            if (nodo->obtenerHash() == hash) continue;
+            if (!primero) primero = nodo;
+            ++distintos;
+        }
+        if (distintos) {
+            *errores << "Advertencia: " << distintos << " nodo(s) no coinciden con el hash guardado en " << nombre_archivo
+                     << " (origen: '" << mostrarRuta(primero) << "'); el archivo se modifico fuera del programa o esta corrupto."
+                     << endl;
+        }
+    }
+
+    // Inserta en los índices los nombres de un subárbol (restauraciones): el resto no se toca
+    void indexarSubarbol(Nodo* subarbol) {
+        MedidaFase medida(Fase::IndicesIncremental);
+        vector<Nodo*> nodos;
+        vector<Nodo*> pila{subarbol};
+        while (!pila.empty()) {
+            Nodo* nodo = pila.back();
+            pila.pop_back();
+            nodos.push_back(nodo);
+            pila.insert(pila.end(), nodo->hijos.begin(), nodo->hijos.end());
+        }
+        indices.altaLote(nodos);
+    }
+
+    // Aplica la política de hijos a las carpetas de un subárbol que no se crearon con anexarHijo
+    // (carga desde JSON, injertos); con HijosLineales no recorre nada
+    static void prepararCarpetas(Nodo* subarbol) {
+        if constexpr (PoliticaHijos::POR_CARPETA) {
+            vector<Nodo*> pila{subarbol};
+            while (!pila.empty()) {
+                Nodo* nodo = pila.back();
+                pila.pop_back();
+                if (nodo->tipo != TipoNodo::Carpeta) continue;
+                PoliticaHijos::preparar(nodo);
+                pila.insert(pila.end(), nodo->hijos.begin(), nodo->hijos.end());
+            }
+        }
+    }
+
+    // Nombres distintos del árbol que empiezan por el prefijo, ordenados (búsqueda por prefijo sin Trie)
+    vector<string_view> nombresConPrefijo(string_view prefijo) const {
+        vector<Simbolo> simbolos;
+        vector<const Nodo*> pila(raiz->hijos.begin(), raiz->hijos.end());
+        while (!pila.empty()) {
+            const Nodo* nodo = pila.back();
+            pila.pop_back();
+            if (nodo->nombre.vista().substr(0, prefijo.size()) == prefijo) simbolos.push_back(nodo->nombre.simbolo());
+            pila.insert(pila.end(), nodo->hijos.begin(), nodo->hijos.end());
+        }
+        std::sort(simbolos.begin(), simbolos.end());
+        simbolos.erase(std::unique(simbolos.begin(), simbolos.end()), simbolos.end());
+        vector<string_view> nombres;
+        nombres.reserve(simbolos.size());
+        for (Simbolo s : simbolos) nombres.push_back(TablaSimbolos::global().texto(s));
+        std::sort(nombres.begin(), nombres.end());
+        return nombres;
+    }
+
+    // Expulsa de la papelera lo que exceda el límite (fuera de lotes: el mapa exacto puede apuntar
+    // aún a nodos borrados hasta la reconstrucción aplazada)
+    void aplicarLimitePapelera() {
+        if (nivel_lote > 0) return;
+        size_t liberadas = papelera.aplicarLimite();
+        if (liberadas) {
+            *avisos << liberadas << " elemento(s) antiguos eliminados de la papelera (limite " << papelera.limiteBytes()
+                    << " bytes)." << endl;
+        }
+    }
+
+    // Función auxiliar para el recorrido en preorden
+    void asistentePreorden(Nodo* nodo, vector<string>& resultado) {
+        if (!nodo) return;
+        string tipo_str = (nodo->tipo == TipoNodo::Carpeta ? "C" : "A");
+        string ruta = mostrarRuta(nodo);
+        resultado.push_back("[" + tipo_str + "] " + ruta);
+        for (Nodo* hijo : nodo->hijos) {
+            asistentePreorden(hijo, resultado);
+        }
+    }
+
+    // Pide una reconstrucción de índices; dentro de un lote se aplaza hasta finalizarLote()
+    void solicitarReconstruccion() {
+        if (nivel_lote > 0) {
+            indices_pendientes = true;
+            return;
+        }
+        reconstruirIndices();
+    }
+
+    // Reconstrucción completa de los índices de búsqueda (usada tras load, rename o movimiento complejo)
+    void reconstruirIndices() {
+        MedidaFase medida(Fase::IndicesReconstruccion);
+        indices_pendientes = false;
+        indices.reconstruir(raiz);
+        *avisos << "Indices (Trie y Hash Map) reconstruidos." << endl;
+    }
+
+public:
+    // Constructor
+    ArbolConPoliticas() {
+        // El reclamador se construye antes que cualquier árbol, así se destruye después que todos
+        Reclamador::global();
+        // Con solo la raíz (que no se indexa) los índices vacíos ya son correctos
+        raiz = new Nodo("/", TipoNodo::Carpeta);
+        PoliticaHijos::preparar(raiz);
+    }
+
+    // Destructor
+    ~ArbolConPoliticas() {
+        delete raiz;
+    }
+
+    /**
+     * @brief Redirige los mensajes del árbol (por ejemplo, a la respuesta de un cliente del servidor).
+     */
+    void redirigirSalida(ostream& nueva_salida, ostream& nuevos_errores) {
+        salida = &nueva_salida;
+        avisos = silencioso ? &flujoNulo() : &nueva_salida;
+        errores = &nuevos_errores;
+    }
+
+    /**
+     * @brief Activa o desactiva las confirmaciones por operación (modo por lotes); los errores se mantienen.
+     */
+    void modoSilencioso(bool activo) {
+        silencioso = activo;
+        avisos = silencioso ? &flujoNulo() : salida;
+    }
+
+    // --- Lotes de escritura ---
+
+    /**
+     * @brief Abre un lote: las reconstrucciones de índices de mv/rename/rm se aplazan hasta cerrarlo.
+     * * Los lotes se pueden anidar; dentro de un lote las búsquedas pueden ver índices desactualizados.
+     */
+    void iniciarLote() {
+        ++nivel_lote;
+    }
+
+    /**
+     * @brief Cierra un lote y, si alguna operación lo pidió, reconstruye los índices una sola vez.
+     */
+    void finalizarLote() {
+        if (nivel_lote > 0 && --nivel_lote == 0) {
+            if (indices_pendientes) reconstruirIndices();
+            aplicarLimitePapelera();
+        }
+    }
+
+    // --- Operaciones CRUD y Persistencia ---
+
+    /**
+     * @brief Crea un nuevo nodo (Carpeta o Archivo) en la ruta padre especificada.
+     */
+    bool crearNodo(string_view ruta_padre, string_view nombre, TipoNodo tipo, string_view contenido = {}) {
+        MedidaFase medida(Fase::Mutacion);
+        Nodo* padre = encontrarNodoPorRuta(ruta_padre);
+        if (!padre || padre->tipo != TipoNodo::Carpeta) {
+            *errores << "Error: Ruta padre '" << ruta_padre << "' no encontrada o no es una carpeta." << endl;
+            return false;
+        }
+
+        // Verificar si ya existe un nodo con ese nombre en el padre
+        if (hijoConNombre(padre, nombre)) {
+            *errores << "Error: Ya existe un nodo con el nombre '" << nombre << "' en esta ruta." << endl;
+            return false;
+        }
+
+        Nodo* nuevoNodo = anexarHijo(padre, nombre, tipo, contenido);
+
+        // Actualizar índices
+        {
+            MedidaFase medida_indices(Fase::IndicesIncremental);
+            indices.alta(nuevoNodo);
+        }
+        historial.registrar({nuevoNodo, padre, padre->hijos.size() - 1, TipoOperacion::Crear});
+
+        *avisos << (tipo == TipoNodo::Carpeta ? "Carpeta" : "Archivo") << " '" << nombre << "' creado en " << ruta_padre << endl;
+        return true;
+    }
+
+    /**
+     * @brief Crea todas las carpetas que falten en la ruta (como 'mkdir -p') en un solo descenso.
+     * * Una vez creado un nivel, los siguientes ya no se buscan: se sabe que no existen.
+     */
+    bool crearRuta(string_view ruta) {
+        MedidaFase medida(Fase::Mutacion);
+        Nodo* actual = raiz;
+        Nodo* primera_creada = nullptr; // Deshacer la quita a ella (y con ella a las demás)
+        bool creando = false;
+        size_t creadas = 0;
+        size_t i = 0;
+
+        for (string_view segmento = siguienteSegmento(ruta, i); !segmento.empty(); segmento = siguienteSegmento(ruta, i)) {
+            Nodo* siguiente = creando ? nullptr : hijoConNombre(actual, segmento);
+            if (siguiente && siguiente->tipo != TipoNodo::Carpeta) {
+                *errores << "Error: '" << mostrarRuta(siguiente) << "' existe y no es una carpeta." << endl;
+                return false;
+            }
+            if (!siguiente) {
+                siguiente = anexarHijo(actual, segmento, TipoNodo::Carpeta);
+                MedidaFase medida_indices(Fase::IndicesIncremental);
+                indices.alta(siguiente);
+                if (!creando) primera_creada = siguiente;
+                creando = true;
+                ++creadas;
+            }
+            actual = siguiente;
+        }
+        if (primera_creada) {
+            Nodo* padre = primera_creada->padre;
+            historial.registrar({primera_creada, padre, padre->hijos.size() - 1, TipoOperacion::Crear});
+        }
+
+        *avisos << "Ruta '" << ruta << "' lista (" << creadas << " carpetas nuevas)." << endl;
+        return true;
+    }
+
+    /**
+     * @brief Crea muchos nodos de una vez; devuelve cuántos se crearon.
+     * * Las entradas se recorren ordenadas por segmentos de ruta ("/a//c" es "/a/c") para que cada una
+     *   reutilice el descenso de la anterior; las carpetas intermedias que falten se crean como en
+     *   'mkdir -p'.
+     * * Los índices se actualizan una sola vez al final, en lote.
+     * * Una entrada cuya ruta ya existe, o que cuelga de un archivo, se informa y se omite.
+     */
+    size_t crearNodos(const vector<EntradaNodo>& entradas) {
+        MedidaFase medida(Fase::Mutacion);
+        historial.descartarRehacer(); // No se registra en el historial
+
+        // Cada ruta se parte una sola vez; todos los segmentos van seguidos en un mismo vector.
+        // Ordenar por segmentos deja el subárbol de cada carpeta contiguo y justo detrás de ella.
+        struct Partida { size_t entrada, inicio, fin; };
+        vector<string_view> todos;
+        vector<Partida> orden;
+        orden.reserve(entradas.size());
+        for (size_t e = 0; e < entradas.size(); ++e) {
+            size_t inicio = todos.size(), i = 0;
+            const string& ruta = entradas[e].ruta;
+            for (string_view s = siguienteSegmento(ruta, i); !s.empty(); s = siguienteSegmento(ruta, i)) {
+                todos.push_back(s);
+            }
+            orden.push_back({e, inicio, todos.size()});
+        }
+        std::sort(orden.begin(), orden.end(), [&todos](const Partida& a, const Partida& b) {
+            return std::lexicographical_compare(todos.begin() + a.inicio, todos.begin() + a.fin,
+                                                todos.begin() + b.inicio, todos.begin() + b.fin);
+        });
+
+        // Pila del descenso actual: nivel k = nodo tras los k primeros segmentos de la entrada anterior.
+        // En una carpeta creada en este lote los hijos llegan ordenados: solo puede repetirse el último.
+        struct Nivel { Nodo* nodo; bool nuevo; };
+        vector<Nivel> pila{{raiz, false}};
+        const string_view* anteriores = nullptr;
+        size_t num_anteriores = 0;
+        vector<Nodo*> creados;
+
+        auto buscarHijo = [](const Nivel& nivel, string_view nombre) -> Nodo* {
+            const ListaHijos& hijos = nivel.nodo->hijos;
+            if (nivel.nuevo) {
+                return (!hijos.empty() && hijos.back()->nombre == nombre) ? hijos.back() : nullptr;
+            }
+            return hijoConNombre(nivel.nodo, nombre);
+        };
+
+        for (const Partida& partida : orden) {
+            const EntradaNodo& entrada = entradas[partida.entrada];
+            const string_view* segmentos = todos.data() + partida.inicio;
+            size_t num_segmentos = partida.fin - partida.inicio;
+            if (num_segmentos == 0) {
+                *errores << "Error: No se puede crear la raiz ('/')." << endl;
+                continue;
+            }
+
+            // Conservar la parte del descenso compartida con la entrada anterior
+            size_t comun = 0;
+            while (comun < num_segmentos - 1 && comun + 1 < pila.size() && comun < num_anteriores &&
+                   segmentos[comun] == anteriores[comun]) {
+                ++comun;
+            }
+            pila.resize(comun + 1);
+            anteriores = segmentos;
+            num_anteriores = num_segmentos;
+
+            // Carpetas intermedias
+            bool valida = true;
+            for (size_t k = comun; k + 1 < num_segmentos; ++k) {
+                Nodo* siguiente = buscarHijo(pila.back(), segmentos[k]);
+                bool nuevo = (siguiente == nullptr);
+                if (nuevo) {
+                    siguiente = anexarHijo(pila.back().nodo, segmentos[k], TipoNodo::Carpeta);
+                    creados.push_back(siguiente);
+                } else if (siguiente->tipo != TipoNodo::Carpeta) {
+                    *errores << "Error: '" << entrada.ruta << "' cuelga de un archivo." << endl;
+                    valida = false;
+                    break;
+                }
+                pila.push_back({siguiente, nuevo});
+            }
+            if (!valida) continue;
+            if (pila.back().nodo->tipo != TipoNodo::Carpeta) {
+                *errores << "Error: '" << entrada.ruta << "' cuelga de un archivo." << endl;
+                continue;
+            }
+
+            // El nodo de la entrada
+            string_view nombre = segmentos[num_segmentos - 1];
+            if (buscarHijo(pila.back(), nombre)) {
+                *errores << "Error: Ya existe un nodo en '" << entrada.ruta << "'." << endl;
+                continue;
+            }
+            Nodo* nodo = anexarHijo(pila.back().nodo, nombre, entrada.tipo, entrada.contenido);
+            creados.push_back(nodo);
+            pila.push_back({nodo, true});
+        }
+
+        // Actualización de índices en un solo paso
+        MedidaFase medida_indices(Fase::IndicesIncremental);
+        indices.altaLote(creados);
+
+        *avisos << creados.size() << " nodos creados en lote." << endl;
+        return creados.size();
+    }
+
+    /**
+     * @brief Renombra un nodo.
+     */
+    bool renombrarNodo(string_view ruta, string_view nuevo_nombre) {
+        MedidaFase medida(Fase::Mutacion);
+        Nodo* nodo = encontrarNodoPorRuta(ruta);
+        if (!nodo || nodo == raiz) {
+            *errores << "Error: Nodo no encontrado o es la raiz ('/')." << endl;
+            return false;
+        }
+
+        Nombre nombre_anterior = nodo->nombre;
+
+        // Verificar si un hermano ya tiene el nuevo nombre
+        Nodo* hermano = hijoConNombre(nodo->padre, nuevo_nombre);
+        if (hermano && hermano != nodo) {
+            *errores << "Error: Ya existe un nodo con el nombre '" << nuevo_nombre << "' en este directorio." << endl;
+            return false;
+        }
+
+        cambiarNombre(nodo, nuevo_nombre);
+        // Se requiere reconstrucción completa de índices por el cambio de nombre
+        solicitarReconstruccion();
+        historial.registrar({nodo, nullptr, nombre_anterior.simbolo(), TipoOperacion::Renombrar});
+
+        *avisos << "Nodo '" << nombre_anterior << "' renombrado a '" << nuevo_nombre << "'." << endl;
+        return true;
+    }
+
+    /**
+     * @brief Elimina un nodo (lo mueve a la papelera, de donde se puede restaurar con restaurarNodo).
+     */
+    bool eliminarNodo(string_view ruta) {
+        MedidaFase medida(Fase::Mutacion);
+        Nodo* nodo = encontrarNodoPorRuta(ruta);
+        if (!nodo || nodo == raiz || !nodo->padre) {
+            *errores << "Error: Nodo no encontrado o es la raiz ('/')." << endl;
+            return false;
+        }
+
+        size_t id = enviarAPapelera(nodo);
+        historial.registrar({nodo, nullptr, id, TipoOperacion::Eliminar});
+        *avisos << "Nodo '" << nodo->nombre << "' movido a la papelera [" << id << "]." << endl;
+        aplicarLimitePapelera();
+        return true;
+    }
+
+    /**
+     * @brief Cuelga de 'ruta_padre' un subárbol construido fuera del árbol (importaciones) e indexa
+     *        todos sus nombres de una vez. Se registra en el historial como una creación.
+     * * Toma la propiedad del subárbol: si no se puede injertar, se libera.
+     */
+    bool injertarSubarbol(const string& ruta_padre, Nodo* subarbol) {
+        return injertarSubarboles(ruta_padre, {subarbol});
+    }
+
+    /**
+     * @brief Como injertarSubarbol, con varios subárboles en la misma carpeta: o todos o ninguno.
+     * * Si algún nombre ya existe en la carpeta (o se repite entre ellos) no se injerta nada y se
+     *   liberan todos. Un solo 'undo' los quita todos (van encadenados en el historial).
+     */
+    bool injertarSubarboles(const string& ruta_padre, const vector<Nodo*>& subarboles) {
+        MedidaFase medida(Fase::Mutacion);
+        auto descartar = [&] {
+            for (Nodo* s : subarboles) Reclamador::global().diferir(s);
+            return false;
+        };
+        Nodo* padre = encontrarNodoPorRuta(ruta_padre);
+        if (!padre || padre->tipo != TipoNodo::Carpeta) {
+            *errores << "Error: Ruta padre '" << ruta_padre << "' no encontrada o no es una carpeta." << endl;
+            return descartar();
+        }
+        unordered_map<Simbolo, const Nodo*> nombres;
+        for (const Nodo* s : subarboles) {
+            if (hijoConNombre(padre, s->nombre) || !nombres.emplace(s->nombre.simbolo(), s).second) {
+                *errores << "Error: Ya existe un nodo con el nombre '" << s->nombre << "' en esta ruta." << endl;
+                return descartar();
+            }
+        }
+        for (size_t i = 0; i < subarboles.size(); ++i) {
+            Nodo* subarbol = subarboles[i];
+            prepararCarpetas(subarbol);
+            vincular(subarbol, padre, padre->hijos.size());
+            indexarSubarbol(subarbol);
+            historial.registrar({subarbol, padre, padre->hijos.size() - 1, TipoOperacion::Crear, i > 0});
+        }
+        return true;
+    }
+
+    /**
+     * @brief Devuelve un elemento de la papelera a su carpeta original.
+     * * Si esa carpeta sigue en el árbol (aunque se haya movido) se usa directamente: no se resuelve
+     *   ninguna ruta. Si se liberó o está en la papelera, se intenta con la ruta que tenía al borrar.
+     * * Solo se indexan los nombres del subárbol restaurado.
+     */
+    bool restaurarNodo(size_t id) {
+        MedidaFase medida(Fase::Mutacion);
+        Nodo* nodo = sacarDePapelera(id);
+        if (!nodo) return false;
+        historial.descartarRehacer(); // No se registra en el historial
+        *avisos << "Nodo '" << nodo->nombre << "' restaurado en " << mostrarRuta(nodo->padre) << endl;
+        return true;
+    }
+
+private:
+    // Desvincula el nodo y lo guarda en la papelera; devuelve su identificador allí
+    size_t enviarAPapelera(Nodo* nodo) {
+        Nodo* padre = nodo->padre;
+        size_t posicion = desvincular(nodo); // Se transfiere la propiedad del puntero a la papelera
+        size_t id = papelera.agregar(nodo, padre, posicion, mostrarRuta(padre));
+
+        // Reconstrucción completa de índices ya que un subárbol completo podría haberse eliminado lógicamente
+        solicitarReconstruccion();
+        return id;
+    }
+
+    // Devuelve al árbol una entrada de la papelera; nullptr (con el error ya informado) si no se puede
+    Nodo* sacarDePapelera(size_t id) {
+        EntradaPapelera e;
+        if (!papelera.extraer(id, e)) {
+            *errores << "Error: No existe el elemento [" << id << "] en la papelera." << endl;
+            return nullptr;
+        }
+
+        Nodo* padre = e.padre_original;
+        if (!padre || !padre->estaDentroDe(raiz)) padre = encontrarNodoPorRuta(e.ruta_padre);
+        if (!padre || padre->tipo != TipoNodo::Carpeta) {
+            *errores << "Error: La carpeta original '" << e.ruta_padre << "' ya no existe." << endl;
+            papelera.devolver(id, std::move(e));
+            return nullptr;
+        }
+        if (hijoConNombre(padre, e.nodo->nombre)) {
+            *errores << "Error: Ya existe un nodo con el nombre '" << e.nodo->nombre << "' en "
+                     << mostrarRuta(padre) << "." << endl;
+            papelera.devolver(id, std::move(e));
+            return nullptr;
+        }
+
+        vincular(e.nodo, padre, e.posicion);
+        indexarSubarbol(e.nodo);
+        return e.nodo;
+    }
+
+    // Aplica la inversa de 'op' y la reescribe para que vuelva a invertirse desde la otra pila.
+    // false (con el error ya informado) si el árbol ya no lo permite; entonces no se toca nada.
+    bool invertir(OperacionHistorial& op, bool deshaciendo) {
+        switch (op.tipo) {
+        case TipoOperacion::Crear:
+            if (deshaciendo) {
+                op.dato = desvincular(op.nodo);
+                solicitarReconstruccion();
+            } else {
+                if (hijoConNombre(op.padre, op.nodo->nombre)) {
+                    *errores << "Error: Ya existe un nodo con el nombre '" << op.nodo->nombre << "' en "
+                             << mostrarRuta(op.padre) << "." << endl;
+                    return false;
+                }
+                vincular(op.nodo, op.padre, op.dato);
+                indexarSubarbol(op.nodo);
+            }
+            return true;
+        case TipoOperacion::Mover: {
+            Nodo* padre_actual = op.nodo->padre;
+            size_t posicion = desvincular(op.nodo);
+            vincular(op.nodo, op.padre, op.dato);
+            op.padre = padre_actual;
+            op.dato = posicion;
+            solicitarReconstruccion();
+            return true;
+        }
+        case TipoOperacion::Renombrar: {
+            string_view otro = TablaSimbolos::global().texto(Simbolo(op.dato));
+            Nodo* hermano = hijoConNombre(op.nodo->padre, otro);
+            if (hermano && hermano != op.nodo) {
+                *errores << "Error: Ya existe un nodo con el nombre '" << otro << "' en este directorio." << endl;
+                return false;
+            }
+            Simbolo actual = op.nodo->nombre.simbolo();
+            cambiarNombre(op.nodo, otro);
+            op.dato = actual;
+            solicitarReconstruccion();
+            return true;
+        }
+        case TipoOperacion::Eliminar:
+            if (deshaciendo) return sacarDePapelera(size_t(op.dato)) != nullptr;
+            op.dato = enviarAPapelera(op.nodo);
+            return true;
+        }
+        return false;
+    }
+
+    // f() dentro de un lote (los índices se reconstruyen una vez al final), que se cierra aunque lance
+    template <typename F>
+    bool enLote(F f) {
+        iniciarLote();
+        bool ok;
+        try {
+            ok = f();
+        } catch (...) {
+            finalizarLote();
+            throw;
+        }
+        finalizarLote();
+        return ok;
+    }
+
+    static const char* describir(TipoOperacion tipo) {
+        switch (tipo) {
+        case TipoOperacion::Crear: return "creacion";
+        case TipoOperacion::Mover: return "movimiento";
+        case TipoOperacion::Renombrar: return "renombrado";
+        case TipoOperacion::Eliminar: return "eliminacion";
+        }
+        return "";
+    }
+
+public:
+    /**
+     * @brief Deshace la última operación registrada (mkdir, touch, mv, rename o rm).
+     * * Cuesta lo mismo que la operación original: se trabaja sobre los nodos guardados, sin
+     *   resolver rutas ni copiar el árbol.
+     * * Si un 'rm' ya no se puede deshacer porque su elemento salió de la papelera, las operaciones
+     *   anteriores tampoco (pueden apuntar a nodos ya liberados): el historial se vacía.
+     */
+    bool deshacer() {
+        MedidaFase medida(Fase::Mutacion);
+        OperacionHistorial op;
+        if (!historial.sacarDeshacer(op)) {
+            *errores << "Error: No hay nada que deshacer." << endl;
+            return false;
+        }
+        size_t encadenadas = 0; // Las que van con la última (se deshacen todas)
+        Nombre nombre;
+        bool ok = enLote([&] {
+            while (true) {
+                if (op.tipo == TipoOperacion::Eliminar) {
+                    // Los identificadores no se reutilizan: si la entrada sigue ahí, es este mismo nodo
+                    const EntradaPapelera* e = papelera.buscar(size_t(op.dato));
+                    if (!e || e->nodo != op.nodo) {
+                        historial.vaciar();
+                        *errores << "Error: El elemento [" << op.dato << "] ya no esta en la papelera; historial vaciado." << endl;
+                        return false;
+                    }
+                }
+                nombre = op.nodo->nombre;
+                if (!invertir(op, true)) {
+                    historial.apilarDeshacer(op);
+                    return false;
+                }
+                historial.apilarRehacer(op);
+                if (!op.con_anterior || !historial.sacarDeshacer(op)) return true;
+                ++encadenadas;
+            }
+        });
+        if (!ok) return false;
+        *avisos << "Deshecho: " << describir(op.tipo) << " de '" << nombre << "'";
+        if (encadenadas) *avisos << " y " << encadenadas << " mas del mismo comando";
+        *avisos << "." << endl;
+        aplicarLimitePapelera();
+        return true;
+    }
+
+    /**
+     * @brief Vuelve a aplicar la última operación deshecha.
+     */
+    bool rehacer() {
+        MedidaFase medida(Fase::Mutacion);
+        OperacionHistorial op;
+        if (!historial.sacarRehacer(op)) {
+            *errores << "Error: No hay nada que rehacer." << endl;
+            return false;
+        }
+        size_t encadenadas = 0;
+        bool ok = enLote([&] {
+            while (true) {
+                if (!invertir(op, false)) {
+                    historial.apilarRehacer(op);
+                    return false;
+                }
+                historial.apilarDeshacer(op);
+                if (!historial.rehacerEncadenada()) return true;
+                historial.sacarRehacer(op);
+                ++encadenadas;
+            }
+        });
+        if (!ok) return false;
+        *avisos << "Rehecho: " << describir(op.tipo) << " de '" << op.nodo->nombre << "'";
+        if (encadenadas) *avisos << " y " << encadenadas << " mas del mismo comando";
+        *avisos << "." << endl;
+        aplicarLimitePapelera();
+        return true;
+    }
+
+    /**
+     * @brief Muestra el estado del historial (como el comando 'historial').
+     */
+    void mostrarHistorial() const {
+        *salida << "Historial: " << historial.operacionesDeshacer() << " operaciones para deshacer, "
+                << historial.operacionesRehacer() << " para rehacer (maximo " << historial.profundidadMaxima()
+                << ")." << endl;
+    }
+
+    /**
+     * @brief Cambia el número máximo de operaciones que se pueden deshacer (0 desactiva el historial).
+     */
+    void limitarHistorial(size_t operaciones) {
+        historial.fijarProfundidad(operaciones);
+        *avisos << "Historial limitado a " << operaciones << " operaciones." << endl;
+    }
+
+    /**
+     * @brief Muestra el contenido de la papelera (como el comando 'papelera').
+     */
+    void listarPapelera() const {
+        if (papelera.vacia()) {
+            *salida << "La papelera de reciclaje esta vacia." << endl;
+            return;
+        }
+        *salida << "\nContenido actual de la papelera (" << papelera.tamano() << " elementos, " << papelera.bytes()
+                << " bytes";
+        if (papelera.limiteBytes()) *salida << " de " << papelera.limiteBytes();
+        *salida << "):" << endl;
+        for (const auto& [id, e] : papelera.contenido()) {
+            string tipo_str = (e.nodo->tipo == TipoNodo::Carpeta ? "DIR" : "FIL");
+            *salida << "  [" << id << "] [" << tipo_str << "] " << e.nodo->nombre << " (desde " << e.ruta_padre
+                    << ", " << e.nodos << " nodos, " << e.bytes << " bytes)" << endl;
+        }
+        *salida << "Estos nodos consumen memoria y no forman parte del arbol activo." << endl;
+    }
+
+    /**
+     * @brief Libera definitivamente todo lo que hay en la papelera; devuelve cuántos elementos había.
+     */
+    size_t vaciarPapelera() {
+        if (papelera.vacia()) {
+            *avisos << "La papelera ya esta vacia. No hay nada que limpiar." << endl;
+            return 0;
+        }
+        size_t num_eliminados = papelera.vaciar();
+        *avisos << "Se han eliminado permanentemente " << num_eliminados << " elementos de la papelera." << endl;
+        return num_eliminados;
+    }
+
+    /**
+     * @brief Cambia el límite de memoria de la papelera (0 = sin límite) y lo aplica en el acto.
+     */
+    void limitarPapelera(size_t bytes) {
+        papelera.fijarLimite(bytes);
+        *avisos << "Limite de la papelera: " << (bytes ? to_string(bytes) + " bytes" : string("sin limite")) << endl;
+        aplicarLimitePapelera();
+    }
+
+    /**
+     * @brief Mueve un nodo de una ruta a otra.
+     */
+    bool moverNodo(string_view ruta_origen, string_view ruta_destino) {
+        MedidaFase medida(Fase::Mutacion);
+        Nodo* nodo_origen = encontrarNodoPorRuta(ruta_origen);
+        Nodo* padre_destino = encontrarNodoPorRuta(ruta_destino);
+
+        if (!nodo_origen || nodo_origen == raiz) {
+            *errores << "Error: Nodo de origen no encontrado o es la raiz." << endl;
+            return false;
+        }
+        if (!padre_destino || padre_destino->tipo != TipoNodo::Carpeta) {
+            *errores << "Error: Destino no encontrado o no es una carpeta." << endl;
+            return false;
+        }
+
+        // Evitar mover un nodo a su propio subdirectorio
+        Nodo* temp = padre_destino;
+        while (temp) {
+            if (temp == nodo_origen) {
+                *errores << "Error: No se puede mover una carpeta a un subdirectorio propio." << endl;
+                return false;
+            }
+            temp = temp->padre;
+        }
+
+        // 1. Eliminar de la lista de hijos del padre actual
+        Nodo* padre_actual = nodo_origen->padre;
+        size_t posicion = desvincular(nodo_origen);
+
+        // 2. Insertar en la lista de hijos del nuevo padre
+        vincular(nodo_origen, padre_destino, padre_destino->hijos.size());
+
+        // Reconstrucción completa de índices por si el movimiento alteró la unicidad de nombres
+        solicitarReconstruccion();
+        historial.registrar({nodo_origen, padre_actual, posicion, TipoOperacion::Mover});
+
+        *avisos << "Nodo '" << nodo_origen->nombre << "' movido a " << ruta_destino << endl;
+        return true;
+    }
+
+    /**
+     * @brief Lista los hijos directos de un nodo (como el comando 'ls').
+     * @param ordenado Por nombre ('ls --sorted'). En una carpeta con 'sort on' se recorre su índice;
+     *        en las demás se ordena una copia de los hijos (O(n log n)).
+     */
+    void listarHijos(string_view ruta, bool ordenado = false) {
+        Nodo* nodo = encontrarNodoPorRuta(ruta);
+        if (!nodo || nodo->tipo != TipoNodo::Carpeta) {
+            *errores << "Error: Ruta '" << ruta << "' no encontrada o no es una carpeta." << endl;
+            return;
+        }
+
+        // Un '\n' por hijo y un solo vaciado al final: con endl, listar una carpeta enorme era una
+        // escritura al terminal (o al socket) por línea
+        *salida << "\nContenido de '" << ruta << "':\n";
+        auto mostrar = [&](const Nodo* hijo) { mostrarHijo(*salida, hijo); };
+        if (!ordenado) {
+            for (Nodo* hijo : nodo->hijos) mostrar(hijo);
+        } else if (nodo->orden()) {
+            nodo->orden()->recorrer(mostrar);
+        } else {
+            vector<Nodo*> copia(nodo->hijos.begin(), nodo->hijos.end());
+            std::sort(copia.begin(), copia.end(), [](const Nodo* a, const Nodo* b) { return a->nombre.vista() < b->nombre.vista(); });
+            for (Nodo* hijo : copia) mostrar(hijo);
+        }
+        if (nodo->hijos.empty()) *salida << "(Vacio)\n";
+        salida->flush();
+    }
+
+    /**
+     * @brief Cursor de paginación que continúa tras el hijo 'nombre'.
+     * * Es el nombre en hexadecimal tras una '/', que ningún nombre contiene: así 'ls --after' distingue
+     *   un cursor de un nombre y el cursor sobrevive a espacios o saltos de línea en el nombre. Como
+     *   solo depende del nombre, sigue valiendo aunque entre tanto se creen o borren hijos.
+     */
+    static string cursorDe(string_view nombre) {
+        static const char digitos[] = "0123456789abcdef";
+        string cursor = "/";
+        for (unsigned char c : nombre) {
+            cursor += digitos[c >> 4];
+            cursor += digitos[c & 0xf];
+        }
+        return cursor;
+    }
+
+    // Nombre tras el que continúa 'despues' (un cursor o un nombre tal cual); false si el cursor no es válido
+    static bool nombreDeCursor(string_view despues, string& nombre) {
+        if (despues.empty() || despues[0] != '/') {
+            nombre = string(despues);
+            return true;
+        }
+        if (despues.size() % 2 == 0) return false;
+        nombre.clear();
+        for (size_t i = 1; i < despues.size(); i += 2) {
+            int valor = 0;
+            for (char c : despues.substr(i, 2)) {
+                int d = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+                if (d < 0) return false;
+                valor = valor * 16 + d;
+            }
+            nombre += char(valor);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Página de hijos por orden de nombre: los primeros 'limite' con nombre mayor que 'despues'.
+     * * Con el índice ordenado ('sort on') cuesta O(log n + limite); sin él hay que mirar todos los
+     *   hijos, O(n + limite log limite).
+     * @param siguiente Cursor para pedir la página siguiente, o vacío si no quedan hijos.
+     * @return false si la ruta no es una carpeta.
+     */
+    bool paginaHijos(string_view ruta, string_view despues, size_t limite, vector<const Nodo*>& pagina,
+                     string& siguiente) const {
+        const Nodo* nodo = encontrarNodoPorRuta(ruta);
+        if (!nodo || nodo->tipo != TipoNodo::Carpeta) return false;
+        pagina.clear();
+        siguiente.clear();
+        limite = max<size_t>(limite, 1);
+        bool hay_mas;
+        if (nodo->orden()) {
+            hay_mas = nodo->orden()->pagina(despues, limite, pagina);
+        } else {
+            for (const Nodo* hijo : nodo->hijos) {
+                if (hijo->nombre.vista() > despues) pagina.push_back(hijo);
+            }
+            auto menor = [](const Nodo* a, const Nodo* b) { return a->nombre.vista() < b->nombre.vista(); };
+            hay_mas = pagina.size() > limite;
+            if (hay_mas) {
+                std::nth_element(pagina.begin(), pagina.begin() + limite, pagina.end(), menor);
+                // Los hermanos con el mismo nombre que el último de la página entran también
+                string_view ultimo = (*std::max_element(pagina.begin(), pagina.begin() + limite, menor))->nombre.vista();
+                auto fin = std::partition(pagina.begin() + limite, pagina.end(),
+                                          [&](const Nodo* h) { return h->nombre.vista() == ultimo; });
+                hay_mas = fin != pagina.end();
+                pagina.erase(fin, pagina.end());
+            }
+            std::sort(pagina.begin(), pagina.end(), menor);
+        }
+        if (hay_mas) siguiente = cursorDe(pagina.back()->nombre.vista());
+        return true;
+    }
+
+    /**
+     * @brief 'ls <ruta> --limit N --after <nombre|cursor>': una página de hijos por nombre y, si quedan
+     *        más, el cursor de la siguiente.
+     */
+    bool listarPagina(string_view ruta, size_t limite, string_view despues) {
+        string nombre;
+        if (!nombreDeCursor(despues, nombre)) {
+            *errores << "Error: Cursor '" << despues << "' no valido." << endl;
+            return false;
+        }
+        vector<const Nodo*> pagina;
+        string siguiente;
+        if (!paginaHijos(ruta, nombre, limite, pagina, siguiente)) {
+            *errores << "Error: Ruta '" << ruta << "' no encontrada o no es una carpeta." << endl;
+            return false;
+        }
+        *salida << "\nContenido de '" << ruta << "':\n";
+        for (const Nodo* hijo : pagina) mostrarHijo(*salida, hijo);
+        if (pagina.empty()) *salida << "(Vacio)\n";
+        if (!siguiente.empty()) *salida << "Siguiente: --after " << siguiente << '\n';
+        salida->flush();
+        return true;
+    }
+
+    /**
+     * @brief Activa o quita el índice por nombre de los hijos de una carpeta (comando 'sort').
+     * * Con él, buscar un hijo cuesta O(log n) en vez de recorrerlos todos, y 'ls --sorted' no ordena
+     *   nada; a cambio cada alta o baja paga, repartido, mover el array ordenado (ver IndiceHijos).
+     *   Conviene en carpetas con miles de hijos. Se guarda con el árbol.
+     */
+    bool ordenarCarpeta(string_view ruta, bool activo) {
+        MedidaFase medida(Fase::Mutacion);
+        Nodo* nodo = encontrarNodoPorRuta(ruta);
+        if (!nodo || nodo->tipo != TipoNodo::Carpeta) {
+            *errores << "Error: Ruta '" << ruta << "' no encontrada o no es una carpeta." << endl;
+            return false;
+        }
+        nodo->ordenarHijos(activo);
+        *avisos << "Indice ordenado de '" << ruta << "' " << (activo ? "activado" : "desactivado") << " ("
+                << nodo->hijos.size() << " hijos)." << endl;
+        return true;
+    }
+
+    /**
+     * @brief Muestra la ruta completa del nodo.
+     */
+    string mostrarRuta(const Nodo* nodo) const {
+        if (!nodo) return "ERROR_NULO";
+        if (nodo == raiz) return "/";
+
+        string ruta = nodo->nombre.str();
+        const Nodo* actual = nodo->padre;
+        while (actual && actual != raiz) {
+            ruta = actual->nombre + "/" + ruta;
+            actual = actual->padre;
+        }
+        return "/" + ruta;
+    }
+
+    /**
+     * @brief Devuelve la lista de nodos en el recorrido Preorden.
+     */
+    vector<string> exportarPreorden() {
+        vector<string> resultado;
+        asistentePreorden(raiz, resultado);
+        return resultado;
+    }
+
+    /**
+     * @brief Guarda el árbol en un archivo JSON (de forma atómica, ver escribirJsonAtomico).
+     */
+    bool guardar(const string& nombre_archivo = "jerarquia.json") const {
+        MedidaFase medida(Fase::Guardar);
+        try {
+            escribirJsonAtomico(raiz->aJson(), nombre_archivo);
+            *avisos << "Arbol guardado con exito en " << nombre_archivo << endl;
+            return true;
+        } catch (const exception& e) {
+            *errores << "Error al guardar el JSON: " << e.what() << endl;
+            return false;
+        }
+    }
+
+    /**
+     * @brief Carga el árbol desde un archivo JSON.
+     * * El árbol nuevo se construye aparte: si el archivo no existe o no es válido, el árbol actual,
+     *   el historial y la papelera quedan como estaban (en el servidor lo comparten todos los clientes).
+     */
+    bool cargar(const string& nombre_archivo = "jerarquia.json") {
+        MedidaFase medida(Fase::Cargar);
+        Nodo* nueva_raiz;
+        vector<pair<Nodo*, uint64_t>> hashes_guardados;
+        try {
+            ifstream i(nombre_archivo);
+            if (!i.is_open()) {
+                *errores << "Advertencia: Archivo " << nombre_archivo << " no encontrado. Iniciando con arbol raiz vacio." << endl;
+                return false;
+            }
+
+            json j;
+            i >> j;
+            i.close();
+            nueva_raiz = Nodo::desdeJson(j, &hashes_guardados); // Si lanza, ya liberó lo que creó
+        } catch (const exception& e) {
+            *errores << "Error al cargar/parsear el JSON: " << e.what() << endl;
+            return false;
+        }
+
+        historial.vaciar(); // Apunta a nodos del árbol anterior
+
+        // Liberar el árbol anterior en segundo plano (la papelera se conserva, pero sus carpetas
+        // originales desaparecen: se restaurará por ruta)
+        papelera.olvidarPadresEn(raiz);
+        Reclamador::global().diferir(raiz);
+        raiz = nueva_raiz;
+        prepararCarpetas(raiz);
+
+        // Reconstruir los índices de búsqueda
+        reconstruirIndices();
+        verificarHashes(hashes_guardados, nombre_archivo);
+
+        *avisos << "Arbol cargado con exito desde " << nombre_archivo << endl;
+        return true;
+    }
+
+    /**
+     * @brief Informe de memoria por subsistema: árbol, contenidos, Trie, mapa exacto y papelera.
+     * * Recorre todas las estructuras (O(n)); pensado para el comando 'mem' y los benchmarks.
+     */
+    ReporteMemoria medirMemoria() const {
+        ReporteMemoria r;
+        r.arbol.bytes = sizeof(ArbolConPoliticas);
+        raiz->medirSubarbol(r.arbol, r.contenidos);
+        indices.medirMemoria(r);
+
+        papelera.medirMemoria(r.papelera);
+        historial.medirMemoria(r.historial);
+        r.simbolos = TablaSimbolos::global().medirMemoria();
+        r.heap_en_uso = memoria::heapEnUso();
+        r.subarboles_por_liberar = Reclamador::global().pendientes();
+        return r;
+    }
+
+    // --- Métodos de Búsqueda Públicos ---
+
+    /**
+     * @brief Realiza autocompletado usando el Trie.
+     * * Sin Trie (IndicesNinguno, IndicesExacto) recorre el árbol: mismo resultado, ordenado y sin duplicados.
+     */
+    vector<string> buscarPorPrefijo(const string& prefijo) {
+        if constexpr (PoliticaIndices::PREFIJO) {
+            return indices.autocompletar(prefijo);
+        } else {
+            vector<string> resultados;
+            for (string_view nombre : nombresConPrefijo(prefijo)) resultados.emplace_back(nombre);
+            return resultados;
+        }
+    }
+
+    /**
+     * @brief Variante sin reservas de buscarPorPrefijo: entrega cada nombre al visitante.
+     * * Sin Trie sí reserva: los nombres se reúnen y ordenan antes de entregarlos.
+     */
+    template <typename Visitante>
+    void visitarPrefijo(string_view prefijo, Visitante visitante) const {
+        if constexpr (PoliticaIndices::PREFIJO) {
+            indices.visitarPrefijo(prefijo, visitante);
+        } else {
+            for (string_view nombre : nombresConPrefijo(prefijo)) visitante(nombre);
+        }
+    }
+
+    /**
+     * @brief Busca un nodo por nombre exacto usando el Hash Map.
+     * * Nota: Esto puede devolver un nodo si hay nombres duplicados en diferentes rutas.
+     * * Sin mapa (IndicesNinguno) recorre el árbol y devuelve la primera coincidencia en preorden.
+     */
+    Nodo* buscarExacto(string_view nombre) const {
+        Simbolo simbolo = TablaSimbolos::global().buscar(nombre);
+        if (simbolo == SIN_SIMBOLO) return nullptr;
+        if constexpr (PoliticaIndices::EXACTO) {
+            return indices.buscar(simbolo);
+        } else {
+            vector<Nodo*> pila(raiz->hijos.rbegin(), raiz->hijos.rend());
+            while (!pila.empty()) {
+                Nodo* nodo = pila.back();
+                pila.pop_back();
+                if (nodo->nombre.simbolo() == simbolo) return nodo;
+                pila.insert(pila.end(), nodo->hijos.rbegin(), nodo->hijos.rend());
+            }
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief Hash Merkle del subárbol en 'ruta' (como el comando 'hash'); false si la ruta no existe.
+     * * Solo se recalculan los nodos cambiados desde la última consulta o el último 'save': con los
+     *   hashes limpios la respuesta cuesta lo que resolver la ruta.
+     * * Completa hashes pendientes dentro de los nodos; es seguro con el candado compartido (ver
+     *   Nodo::obtenerHash).
+     */
+    bool hashDe(string_view ruta, uint64_t& hash) const {
+        const Nodo* nodo = encontrarNodoPorRuta(ruta);
+        if (!nodo) {
+            *errores << "Error: Ruta '" << ruta << "' no encontrada." << endl;
+            return false;
+        }
+        hash = nodo->obtenerHash();
+        return true;
+    }
+
+    // --- Consultas de solo lectura (no modifican el árbol ni reservan memoria) ---
+
+    /**
+     * @brief Devuelve el nodo de una ruta, o nullptr si no existe.
+     */
+    Nodo* obtenerNodo(string_view ruta) const {
+        return encontrarNodoPorRuta(ruta);
+    }
+
+    /**
+     * @brief Recorre los hijos directos de una carpeta; devuelve false si la ruta no es una carpeta.
+     */
+    template <typename Visitante>
+    bool visitarHijos(string_view ruta, Visitante visitante) const {
+        const Nodo* nodo = encontrarNodoPorRuta(ruta);
+        if (!nodo || nodo->tipo != TipoNodo::Carpeta) return false;
+        for (const Nodo* hijo : nodo->hijos) visitante(*hijo);
+        return true;
+    }
+};
+
+// La configuración de siempre: hijos en vector (índice opcional con 'sort') y los dos índices globales
+using ArbolJerarquia = ArbolConPoliticas<HijosLineales, IndicesCompletos>;
+
+#endif // ARBOL_HPP
@@ -0,0 +1,320 @@
+// Suite de benchmarks de ArbolJerarquia sobre árboles sintéticos reproducibles.
+//
+// Uso: bench_arbol [opciones]
+//   --tamanos 1000,10000,100000,1000000   Tamaños del árbol (nodos); admite 1e7
+//   --semilla N                           Semilla del generador (por defecto 42)
+//   --fanout MIN:MAX                      Hijos por carpeta (por defecto 2:32)
+//   --profundidad N                       Profundidad máxima (por defecto 12)
+//   --nombre MIN:MAX                      Longitud de los nombres (por defecto 3:16)
+//   --comunes P                           Probabilidad de nombre frecuente (por defecto 0.1)
+//   --presupuesto S                       Segundos máximos por operación y tamaño (por defecto 1)
+//   --fanouts 16,256,4096,65536           Hijos de la carpeta en la prueba de carpeta ancha ("" = omitirla)
+//   --arboles defecto,ordenado,hash,minimo Instancias de ArbolConPoliticas que se miden (ver más abajo)
+//   --formato json|csv                    Formato de salida (por defecto json)
+//   --salida ARCHIVO                      Archivo de resultados (por defecto stdout)
+//
+// Cada operación se repite hasta agotar el presupuesto o el número máximo de repeticiones y se
+// informa la media, p50 y p99 en nanosegundos por operación. La salida JSON incluye además el informe
+// de memoria por subsistema (ArbolConPoliticas::medirMemoria) de cada instancia y tamaño.
+//
+// La prueba de carpeta ancha llena una sola carpeta con N hijos, sin y con 'sort on', y mide lo que
+// cuesta crear cada hijo frente a lo que cuesta encontrarlo después (insertarHijo_* / buscarHijo_*;
+// la columna 'nodos' es N).
+//
+// Cada medida lleva la instancia del árbol que la produjo (campo/columna 'arbol'):
+//   defecto   ArbolJerarquia (HijosLineales, IndicesCompletos)
+//   ordenado  HijosOrdenados, IndicesCompletos: todas las carpetas con índice ordenado
+//   hash      HijosHash, IndicesExacto: tabla hash por carpeta y sin Trie
+//   minimo    HijosLineales, IndicesNinguno: sin índices ('search' recorre el árbol)
+// En la carpeta ancha, 'defecto' se mide sin y con 'sort on' (sufijos _lineal/_ordenada) y 'hash'
+// con su tabla (_hash).
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+
+#include "generador.hpp"
+
+using Reloj = chrono::steady_clock;
+
+struct Medida {
+    string arbol;
+    string operacion;
+    size_t nodos = 0;
+    size_t repeticiones = 0;
+    double media_ns = 0, p50_ns = 0, p99_ns = 0, total_s = 0;
+};
+
+struct Opciones {
+    vector<size_t> tamanos{1000, 10000, 100000, 1000000};
+    vector<size_t> fanouts{16, 256, 4096, 65536};
+    vector<string> arboles{"defecto", "ordenado", "hash", "minimo"};
+    ConfigGenerador generador;
+    double presupuesto_s = 1.0;
+    string formato = "json";
+    string salida;
+};
+
+static bool parLimites(const string& texto, int& a, int& b) {
+    size_t sep = texto.find(':');
+    if (sep == string::npos) return false;
+    a = stoi(texto.substr(0, sep));
+    b = stoi(texto.substr(sep + 1));
+    return a > 0 && b >= a;
+}
+
+static bool leerOpciones(int argc, char* argv[], Opciones& o) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string clave = argv[i], valor = argv[i + 1];
+        if (clave == "--tamanos") {
+            o.tamanos.clear();
+            stringstream ss(valor);
+            string t;
+            while (getline(ss, t, ',')) o.tamanos.push_back(size_t(stod(t)));
+        } else if (clave == "--fanouts") {
+            o.fanouts.clear();
+            stringstream ss(valor);
+            string t;
+            while (getline(ss, t, ',')) o.fanouts.push_back(size_t(stod(t)));
+        } else if (clave == "--arboles") {
+            o.arboles.clear();
+            stringstream ss(valor);
+            string t;
+            while (getline(ss, t, ',')) {
+                if (t != "defecto" && t != "ordenado" && t != "hash" && t != "minimo") return false;
+                o.arboles.push_back(t);
+            }
+        } else if (clave == "--semilla") o.generador.semilla = uint32_t(stoul(valor));
+        else if (clave == "--fanout") { if (!parLimites(valor, o.generador.fanout_min, o.generador.fanout_max)) return false; }
+        else if (clave == "--profundidad") o.generador.profundidad_max = stoi(valor);
+        else if (clave == "--nombre") { if (!parLimites(valor, o.generador.largo_min, o.generador.largo_max)) return false; }
+        else if (clave == "--comunes") o.generador.prob_nombre_comun = stod(valor);
+        else if (clave == "--presupuesto") o.presupuesto_s = stod(valor);
+        else if (clave == "--formato") o.formato = valor;
+        else if (clave == "--salida") o.salida = valor;
+        else return false;
+    }
+    return (argc % 2 == 1) && (o.formato == "json" || o.formato == "csv");
+}
+
+/**
+ * @brief Ejecuta op(i) para i = 0, 1, ... hasta 'maximo' veces o hasta agotar el presupuesto.
+ * * Si cada llamada hace varias operaciones (ej: ida y vuelta), 'por_llamada' reparte el tiempo.
+ */
+template <typename Op>
+static Medida medir(const string& nombre, size_t nodos, size_t maximo, double presupuesto_s, Op op,
+                    int por_llamada = 1) {
+    vector<double> tiempos;
+    tiempos.reserve(min<size_t>(maximo, 1 << 20));
+    auto inicio = Reloj::now();
+    for (size_t i = 0; i < maximo; ++i) {
+        auto t0 = Reloj::now();
+        op(i);
+        auto t1 = Reloj::now();
+        tiempos.push_back(chrono::duration<double, nano>(t1 - t0).count() / por_llamada);
+        if (chrono::duration<double>(t1 - inicio).count() > presupuesto_s) break;
+    }
+
+    Medida m;
+    m.operacion = nombre;
+    m.nodos = nodos;
+    m.repeticiones = tiempos.size() * size_t(por_llamada);
+    for (double t : tiempos) m.total_s += t * por_llamada / 1e9;
+    m.media_ns = m.total_s * 1e9 / max<size_t>(1, m.repeticiones);
+    sort(tiempos.begin(), tiempos.end());
+    m.p50_ns = tiempos[tiempos.size() / 2];
+    m.p99_ns = tiempos[min(tiempos.size() - 1, tiempos.size() * 99 / 100)];
+    return m;
+}
+
+// Informe de memoria de una instancia y un tamaño
+struct MemoriaArbol {
+    string arbol;
+    size_t nodos = 0;
+    ReporteMemoria reporte;
+};
+
+// Marca con la instancia las medidas añadidas desde 'desde'
+static void etiquetar(vector<Medida>& resultados, size_t desde, const string& arbol) {
+    for (size_t i = desde; i < resultados.size(); ++i) resultados[i].arbol = arbol;
+}
+
+template <typename Arbol>
+static void medirTamano(const string& nombre_arbol, size_t nodos, const Opciones& o, vector<Medida>& resultados,
+                        vector<MemoriaArbol>& memorias) {
+    ConfigGenerador config = o.generador;
+    config.nodos = nodos;
+    vector<EntradaNodo> entradas = GeneradorArbol(config).generar();
+
+    vector<size_t> archivos, carpetas;
+    for (size_t i = 0; i < entradas.size(); ++i) {
+        (entradas[i].tipo == TipoNodo::Archivo ? archivos : carpetas).push_back(i);
+    }
+    if (carpetas.empty() || archivos.empty()) {
+        cerr << "Aviso: arbol de " << nodos << " nodos sin carpetas o sin archivos; se omite." << endl;
+        return;
+    }
+    mt19937 gen(config.semilla + 1);
+    auto elegir = [&](const vector<size_t>& v) { return v[uniform_int_distribution<size_t>(0, v.size() - 1)(gen)]; };
+    auto nombreDe = [](const string& ruta) { return ruta.substr(ruta.rfind('/') + 1); };
+    auto unir = [](const string& padre, const string& nombre) { return (padre == "/" ? "" : padre) + "/" + nombre; };
+
+    size_t desde = resultados.size();
+    Arbol arbol;
+    arbol.modoSilencioso(true);
+
+    // crearNodo: el árbol completo, nodo a nodo en orden de anchura
+    resultados.push_back(medir("crearNodo", nodos, entradas.size(), 1e9, [&](size_t i) {
+        auto [padre, nombre] = GeneradorArbol::separar(entradas[i].ruta);
+        arbol.crearNodo(padre, nombre, entradas[i].tipo, entradas[i].contenido);
+    }));
+    memorias.push_back({nombre_arbol, nodos, arbol.medirMemoria()});
+
+    resultados.push_back(medir("encontrarNodoPorRuta", nodos, 1000000, o.presupuesto_s, [&](size_t) {
+        volatile bool ok = arbol.obtenerNodo(entradas[elegir(archivos)].ruta) != nullptr;
+        (void)ok;
+    }));
+
+    resultados.push_back(medir("buscarExacto", nodos, 1000000, o.presupuesto_s, [&](size_t) {
+        const string& ruta = entradas[elegir(archivos)].ruta;
+        volatile bool ok = arbol.buscarExacto(string_view(ruta).substr(ruta.rfind('/') + 1)) != nullptr;
+        (void)ok;
+    }));
+
+    resultados.push_back(medir("autocompletar", nodos, 100000, o.presupuesto_s, [&](size_t) {
+        string nombre = nombreDe(entradas[elegir(archivos)].ruta);
+        volatile size_t n = arbol.buscarPorPrefijo(nombre.substr(0, 3)).size();
+        (void)n;
+    }));
+
+    // mv y rename reconstruyen los índices completos: pocas repeticiones en árboles grandes.
+    // Cada llamada hace ida y vuelta para dejar el árbol como estaba.
+    resultados.push_back(medir("moverNodo", nodos, 500, o.presupuesto_s, [&](size_t) {
+        const string& archivo = entradas[elegir(archivos)].ruta;
+        const string& carpeta = entradas[elegir(carpetas)].ruta;
+        if (arbol.moverNodo(archivo, carpeta)) {
+            arbol.moverNodo(unir(carpeta, nombreDe(archivo)), GeneradorArbol::separar(archivo).first);
+        }
+    }, 2));
+
+    resultados.push_back(medir("renombrarNodo", nodos, 500, o.presupuesto_s, [&](size_t) {
+        const string& archivo = entradas[elegir(archivos)].ruta;
+        string padre = GeneradorArbol::separar(archivo).first;
+        if (arbol.renombrarNodo(archivo, "__bench_tmp")) {
+            arbol.renombrarNodo(unir(padre, "__bench_tmp"), nombreDe(archivo));
+        }
+    }, 2));
+
+    string archivo_tmp = "bench_arbol_" + to_string(nodos) + ".json";
+    resultados.push_back(medir("guardar", nodos, 20, o.presupuesto_s, [&](size_t) { arbol.guardar(archivo_tmp); }));
+    resultados.push_back(medir("cargar", nodos, 20, o.presupuesto_s, [&](size_t) { arbol.cargar(archivo_tmp); }));
+    remove(archivo_tmp.c_str());
+    etiquetar(resultados, desde, nombre_arbol);
+}
+
+// Una instancia por nombre de --arboles
+static void medirTamano(const string& arbol, size_t nodos, const Opciones& o, vector<Medida>& resultados,
+                        vector<MemoriaArbol>& memorias) {
+    if (arbol == "defecto") medirTamano<ArbolJerarquia>(arbol, nodos, o, resultados, memorias);
+    else if (arbol == "ordenado") medirTamano<ArbolConPoliticas<HijosOrdenados, IndicesCompletos>>(arbol, nodos, o, resultados, memorias);
+    else if (arbol == "hash") medirTamano<ArbolConPoliticas<HijosHash, IndicesExacto>>(arbol, nodos, o, resultados, memorias);
+    else medirTamano<ArbolConPoliticas<HijosLineales, IndicesNinguno>>(arbol, nodos, o, resultados, memorias);
+}
+
+// Una carpeta con 'fanout' hijos, con el índice ordenado o sin él ('sufijo' distingue las variantes)
+template <typename Arbol>
+static void medirCarpetaAncha(const string& nombre_arbol, size_t fanout, bool ordenada, const string& sufijo,
+                              const Opciones& o, vector<Medida>& resultados) {
+    vector<string> nombres(fanout);
+    for (size_t i = 0; i < fanout; ++i) nombres[i] = "archivo_" + to_string(i);
+    mt19937 gen(o.generador.semilla);
+    shuffle(nombres.begin(), nombres.end(), gen);
+
+    size_t desde = resultados.size();
+    Arbol arbol;
+    arbol.modoSilencioso(true);
+    arbol.crearNodo("/", "ancha", TipoNodo::Carpeta);
+    if (ordenada) arbol.ordenarCarpeta("/ancha", true);
+
+    resultados.push_back(medir("insertarHijo" + sufijo, fanout, fanout, 1e9, [&](size_t i) {
+        arbol.crearNodo("/ancha", nombres[i], TipoNodo::Archivo);
+    }));
+
+    vector<string> rutas(fanout);
+    for (size_t i = 0; i < fanout; ++i) rutas[i] = "/ancha/" + nombres[i];
+    resultados.push_back(medir("buscarHijo" + sufijo, fanout, 1000000, o.presupuesto_s, [&](size_t) {
+        volatile bool ok = arbol.obtenerNodo(rutas[uniform_int_distribution<size_t>(0, fanout - 1)(gen)]) != nullptr;
+        (void)ok;
+    }));
+    etiquetar(resultados, desde, nombre_arbol);
+}
+
+int main(int argc, char* argv[]) {
+    Opciones o;
+    if (!leerOpciones(argc, argv, o)) {
+        cerr << "Uso: bench_arbol [--tamanos N,N,...] [--semilla N] [--fanout MIN:MAX] [--profundidad N]"
+                " [--nombre MIN:MAX] [--comunes P] [--presupuesto S] [--fanouts N,N,...] [--arboles A,A,...]"
+                " [--formato json|csv]"
+                " [--salida ARCHIVO]" << endl;
+        return 1;
+    }
+
+    vector<Medida> resultados;
+    vector<MemoriaArbol> memorias;
+    for (size_t nodos : o.tamanos) {
+        for (const string& arbol : o.arboles) {
+            cerr << "Midiendo arbol '" << arbol << "' de " << nodos << " nodos..." << endl;
+            medirTamano(arbol, nodos, o, resultados, memorias);
+        }
+    }
+    bool con_hash = find(o.arboles.begin(), o.arboles.end(), "hash") != o.arboles.end();
+    for (size_t fanout : o.fanouts) {
+        cerr << "Midiendo carpeta de " << fanout << " hijos..." << endl;
+        medirCarpetaAncha<ArbolJerarquia>("defecto", fanout, false, "_lineal", o, resultados);
+        medirCarpetaAncha<ArbolJerarquia>("defecto", fanout, true, "_ordenada", o, resultados);
+        if (con_hash) {
+            medirCarpetaAncha<ArbolConPoliticas<HijosHash, IndicesExacto>>("hash", fanout, false, "_hash", o, resultados);
+        }
+    }
+
+    ofstream archivo;
+    if (!o.salida.empty()) archivo.open(o.salida);
+    ostream& out = o.salida.empty() ? cout : archivo;
+
+    if (o.formato == "csv") {
+        out << "arbol,operacion,nodos,repeticiones,media_ns,p50_ns,p99_ns,total_s\n";
+        for (const Medida& m : resultados) {
+            out << m.arbol << ',' << m.operacion << ',' << m.nodos << ',' << m.repeticiones << ',' << fixed << setprecision(1)
+                << m.media_ns << ',' << m.p50_ns << ',' << m.p99_ns << ',' << setprecision(6) << m.total_s << '\n';
+        }
+    } else {
+        const ConfigGenerador& g = o.generador;
+        json j;
+        j["semilla"] = g.semilla;
+        j["generador"] = {{"fanout_min", g.fanout_min}, {"fanout_max", g.fanout_max},
+                          {"profundidad_max", g.profundidad_max}, {"prob_carpeta", g.prob_carpeta},
+                          {"largo_min", g.largo_min}, {"largo_max", g.largo_max},
+                          {"prob_nombre_comun", g.prob_nombre_comun}};
+        j["marca_tiempo"] = long(time(nullptr));
+        j["resultados"] = json::array();
+        for (const Medida& m : resultados) {
+            j["resultados"].push_back({{"arbol", m.arbol}, {"operacion", m.operacion}, {"nodos", m.nodos},
+                                       {"repeticiones", m.repeticiones}, {"media_ns", m.media_ns},
+                                       {"p50_ns", m.p50_ns}, {"p99_ns", m.p99_ns}, {"total_s", m.total_s}});
+        }
+        j["memoria"] = json::array();
+        for (const MemoriaArbol& memoria : memorias) {
+            json m = json::parse(memoria.reporte.aJson());
+            m["arbol"] = memoria.arbol;
+            m["nodos"] = memoria.nodos;
+            j["memoria"].push_back(m);
+        }
+        out << setw(2) << j << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Benchmark de recorridos: ArbolJerarquia (Nodo enlazados por punteros) frente a ArbolCompacto
+// (arrays paralelos con Id de 32 bits).
+//
+// Uso: bench_compacto [nodos] [repeticiones] [semilla]
+//
+// El árbol sale de GeneradorArbol (creado en orden de anchura). ArbolCompacto se mide dos veces:
+// con los Id en ese orden de creación y tras compactar() (Id en preorden). De cada pasada se informa
+// el mejor tiempo de 'repeticiones' y los nanosegundos por nodo.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+#include "generador.hpp"
+#include "compacto.hpp"
+
+using Reloj = chrono::steady_clock;
+
+// Mejor tiempo (segundos) de 'repeticiones' llamadas a op()
+template <typename Op>
+static double mejorTiempo(int repeticiones, Op op) {
+    double mejor = 1e30;
+    for (int i = 0; i < repeticiones; ++i) {
+        auto t0 = Reloj::now();
+        op();
+        mejor = min(mejor, chrono::duration<double>(Reloj::now() - t0).count());
+    }
+    return mejor;
+}
+
+// Preorden sobre los punteros de Nodo::hijos (pila explícita, como un recorrido sin recursión)
+template <typename Visitante>
+static void preordenPunteros(const Nodo* raiz, Visitante visitante) {
+    vector<const Nodo*> pila{raiz};
+    while (!pila.empty()) {
+        const Nodo* n = pila.back();
+        pila.pop_back();
+        visitante(n);
+        for (auto it = n->hijos.rbegin(); it != n->hijos.rend(); ++it) pila.push_back(*it);
+    }
+}
+
+static volatile size_t sumidero; // Para que el compilador no elimine los recorridos
+
+static void fila(const string& pasada, double punteros, double creacion, double compactado, size_t nodos) {
+    auto celda = [&](double s) {
+        cout << setw(12) << fixed << setprecision(2) << s * 1e3 << setw(9) << setprecision(1) << s * 1e9 / nodos;
+    };
+    cout << left << setw(22) << pasada << right;
+    celda(punteros);
+    celda(creacion);
+    celda(compactado);
+    cout << '\n';
+}
+
+int main(int argc, char* argv[]) {
+    ConfigGenerador config;
+    config.nodos = argc > 1 ? size_t(atof(argv[1])) : 1000000;
+    int repeticiones = argc > 2 ? atoi(argv[2]) : 5;
+    if (argc > 3) config.semilla = uint32_t(atoi(argv[3]));
+    vector<EntradaNodo> entradas = GeneradorArbol(config).generar();
+
+    ArbolJerarquia arbol;
+    arbol.modoSilencioso(true);
+    for (const EntradaNodo& e : entradas) {
+        auto [padre, nombre] = GeneradorArbol::separar(e.ruta);
+        arbol.crearNodo(padre, nombre, e.tipo, e.contenido);
+    }
+
+    // Mismo orden de creación (anchura) que el ArbolJerarquia: Id consecutivos por niveles
+    ArbolCompacto creacion;
+    for (const EntradaNodo& e : entradas) {
+        auto [padre, nombre] = GeneradorArbol::separar(e.ruta);
+        creacion.crearNodo(padre, nombre, e.tipo, e.contenido);
+    }
+    ArbolCompacto compactado;
+    compactado.cargarDesde(arbol);
+    compactado.compactar();
+    size_t nodos = creacion.tamano();
+
+    const Nodo* raiz = arbol.obtenerNodo("/");
+    auto recorrer = [&](const ArbolCompacto& c) {
+        return mejorTiempo(repeticiones, [&] {
+            size_t suma = 0;
+            c.recorrerPreorden(ArbolCompacto::RAIZ, [&](ArbolCompacto::Id n, size_t p) { suma += c.nombreDe(n).size() + p; });
+            sumidero = suma;
+        });
+    };
+    double r_punteros = mejorTiempo(repeticiones, [&] {
+        size_t suma = 0;
+        preordenPunteros(raiz, [&](const Nodo* n) { suma += n->nombre.vista().size(); });
+        sumidero = suma;
+    });
+
+    auto agregar = [&](const ArbolCompacto& c) {
+        return mejorTiempo(repeticiones, [&] {
+            ArbolCompacto::Resumen r;
+            c.resumen("/", r);
+            sumidero = r.carpetas + r.archivos + r.bytes_contenido;
+        });
+    };
+    double a_punteros = mejorTiempo(repeticiones, [&] {
+        size_t carpetas = 0, archivos = 0, bytes = 0;
+        preordenPunteros(raiz, [&](const Nodo* n) {
+            ++(n->tipo == TipoNodo::Carpeta ? carpetas : archivos);
+            bytes += n->contenido().size();
+        });
+        sumidero = carpetas + archivos + bytes;
+    });
+
+    auto exportar = [&](const ArbolCompacto& c) {
+        return mejorTiempo(repeticiones, [&] { sumidero = c.exportarPreorden().size(); });
+    };
+    double e_punteros = mejorTiempo(repeticiones, [&] { sumidero = arbol.exportarPreorden().size(); });
+
+    // Rutas de archivos al azar (las mismas para los tres)
+    vector<string> rutas;
+    mt19937 gen(config.semilla + 1);
+    for (int i = 0; i < 200000; ++i) rutas.push_back(entradas[gen() % entradas.size()].ruta);
+    auto buscar = [&](const ArbolCompacto& c) {
+        return mejorTiempo(repeticiones, [&] {
+            size_t encontrados = 0;
+            for (const string& ruta : rutas) encontrados += c.obtenerNodo(ruta) != ArbolCompacto::NINGUNO;
+            sumidero = encontrados;
+        });
+    };
+    double b_punteros = mejorTiempo(repeticiones, [&] {
+        size_t encontrados = 0;
+        for (const string& ruta : rutas) encontrados += arbol.obtenerNodo(ruta) != nullptr;
+        sumidero = encontrados;
+    });
+
+    ReporteMemoria memoria = arbol.medirMemoria();
+    cout << "Arbol de " << nodos << " nodos (semilla " << config.semilla << "), mejor de " << repeticiones
+         << " repeticiones\n";
+    cout << left << setw(22) << "pasada" << right << setw(21) << "punteros ms  ns/n" << setw(21)
+         << "arrays ms  ns/n" << setw(21) << "compactado ms  ns/n" << '\n';
+    fila("recorrido preorden", r_punteros, recorrer(creacion), recorrer(compactado), nodos);
+    fila("resumen (agregado)", a_punteros, agregar(creacion), agregar(compactado), nodos);
+    fila("exportar preorden", e_punteros, exportar(creacion), exportar(compactado), nodos);
+    fila("200k rutas", b_punteros, buscar(creacion), buscar(compactado), rutas.size());
+    cout << "Memoria del arbol (con contenidos): punteros " << memoria.arbol.bytes + memoria.contenidos.bytes
+         << " bytes, arrays " << creacion.bytes() << " bytes, compactado " << compactado.bytes() << " bytes\n";
+    return 0;
+}
@@ -0,0 +1,146 @@
+// Benchmark de ArbolConcurrente: mezcla de lecturas y escrituras con 1..N hilos.
+//
+// Uso: bench_concurrencia [hilos_max] [segundos_por_punto] [porcentaje_lecturas] [carpetas] [archivos_por_carpeta]
+// Salida: una fila por número de hilos con el throughput total y el tamaño medio de lote de escritura.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <cstdlib>
+
+#include "concurrente.hpp"
+
+using Reloj = chrono::steady_clock;
+
+struct ResultadoHilo {
+    size_t lecturas = 0;
+    size_t escrituras = 0;
+    size_t aciertos = 0; // Evita que el compilador descarte las lecturas
+};
+
+// Construye /dN/fM con contenido corto y devuelve las rutas de todos los archivos
+static vector<string> poblar(ArbolConcurrente& arbol, int carpetas, int archivos) {
+    vector<string> rutas;
+    rutas.reserve(size_t(carpetas) * archivos);
+    for (int d = 0; d < carpetas; ++d) {
+        string carpeta = "d" + to_string(d);
+        arbol.crearNodo("/", carpeta, TipoNodo::Carpeta);
+        for (int f = 0; f < archivos; ++f) {
+            string archivo = "f" + to_string(d) + "_" + to_string(f) + ".txt";
+            arbol.crearNodo("/" + carpeta, archivo, TipoNodo::Archivo, "contenido");
+            rutas.push_back("/" + carpeta + "/" + archivo);
+        }
+    }
+    return rutas;
+}
+
+static void trabajador(ArbolConcurrente& arbol, const vector<string>& rutas, int id, int pct_lecturas,
+                       atomic<bool>& iniciar, atomic<bool>& parar, ResultadoHilo& res) {
+    mt19937 gen(1234 + id);
+    uniform_int_distribution<size_t> elegir_ruta(0, rutas.size() - 1);
+    uniform_int_distribution<int> elegir_pct(0, 99);
+    uniform_int_distribution<int> elegir_lectura(0, 3);
+    string carpeta_propia = "/w" + to_string(id);
+    size_t siguiente_archivo = 0;
+
+    while (!iniciar.load(memory_order_acquire)) this_thread::yield();
+
+    while (!parar.load(memory_order_relaxed)) {
+        if (elegir_pct(gen) < pct_lecturas) {
+            const string& ruta = rutas[elegir_ruta(gen)];
+            switch (elegir_lectura(gen)) {
+                case 0: // Resolución de ruta
+                    res.aciertos += arbol.existe(ruta);
+                    break;
+                case 1: { // ls de la carpeta que contiene la ruta
+                    string_view carpeta(ruta.data(), ruta.find('/', 1));
+                    arbol.listarHijos(carpeta, [&](const Nodo&) { ++res.aciertos; });
+                    break;
+                }
+                case 2: { // Búsqueda exacta por nombre
+                    string_view nombre = string_view(ruta).substr(ruta.rfind('/') + 1);
+                    arbol.buscarExacto(nombre, [&](const Nodo&) { ++res.aciertos; });
+                    break;
+                }
+                default: { // Autocompletado por prefijo corto
+                    string_view prefijo = string_view(ruta).substr(ruta.rfind('/') + 1, 4);
+                    arbol.buscarPorPrefijo(prefijo, [&](string_view) { ++res.aciertos; });
+                    break;
+                }
+            }
+            ++res.lecturas;
+        } else {
+            arbol.crearNodo(carpeta_propia, "n" + to_string(siguiente_archivo++), TipoNodo::Archivo);
+            ++res.escrituras;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int hilos_max = argc > 1 ? atoi(argv[1]) : int(max(1u, thread::hardware_concurrency()));
+    double segundos = argc > 2 ? atof(argv[2]) : 1.0;
+    int pct_lecturas = argc > 3 ? atoi(argv[3]) : 95;
+    int carpetas = argc > 4 ? atoi(argv[4]) : 100;
+    int archivos = argc > 5 ? atoi(argv[5]) : 100;
+
+    // Los mensajes de cada operación del árbol no forman parte de la medida
+    streambuf* salida_original = cout.rdbuf(nullptr);
+    streambuf* errores_original = cerr.rdbuf(nullptr);
+
+    // Potencias de dos hasta hilos_max, incluyendo siempre hilos_max
+    vector<int> puntos;
+    for (int h = 1; h < hilos_max; h *= 2) puntos.push_back(h);
+    puntos.push_back(max(1, hilos_max));
+
+    vector<string> resumen;
+    for (int hilos : puntos) {
+        ArbolConcurrente arbol;
+        vector<string> rutas = poblar(arbol, carpetas, archivos);
+        for (int i = 0; i < hilos; ++i) arbol.crearNodo("/", "w" + to_string(i), TipoNodo::Carpeta);
+
+        atomic<bool> iniciar{false}, parar{false};
+        vector<ResultadoHilo> resultados(hilos);
+        vector<thread> trabajadores;
+        for (int i = 0; i < hilos; ++i) {
+            trabajadores.emplace_back(trabajador, ref(arbol), cref(rutas), i, pct_lecturas,
+                                      ref(iniciar), ref(parar), ref(resultados[i]));
+        }
+
+        auto inicio = Reloj::now();
+        iniciar.store(true, memory_order_release);
+        this_thread::sleep_for(chrono::duration<double>(segundos));
+        parar.store(true);
+        for (thread& t : trabajadores) t.join();
+        double transcurrido = chrono::duration<double>(Reloj::now() - inicio).count();
+
+        ResultadoHilo total;
+        for (const ResultadoHilo& r : resultados) {
+            total.lecturas += r.lecturas;
+            total.escrituras += r.escrituras;
+            total.aciertos += r.aciertos;
+        }
+
+        ostringstream fila;
+        fila << setw(6) << hilos
+             << setw(16) << fixed << setprecision(0) << (total.lecturas + total.escrituras) / transcurrido
+             << setw(16) << total.lecturas / transcurrido
+             << setw(16) << total.escrituras / transcurrido
+             << setw(12) << setprecision(2) << arbol.escriturasPorLote();
+        resumen.push_back(fila.str());
+    }
+
+    cout.rdbuf(salida_original);
+    cerr.rdbuf(errores_original);
+
+    cout << "Mezcla: " << pct_lecturas << "% lecturas, arbol de " << carpetas << "x" << archivos
+         << " archivos, " << segundos << " s por punto" << endl;
+    cout << setw(6) << "hilos" << setw(16) << "ops/s" << setw(16) << "lecturas/s"
+         << setw(16) << "escrituras/s" << setw(12) << "esc/lote" << endl;
+    for (const string& fila : resumen) cout << fila << endl;
+    return 0;
+}
@@ -0,0 +1,165 @@
+// Benchmark de latencia de lectura bajo carga de escritura:
+// ArbolConcurrente (candado lector/escritor) frente a ArbolPersistente (instantáneas sin bloqueo).
+//
+// Uso: bench_persistente [lectores] [escritores] [segundos] [carpetas] [archivos_por_carpeta]
+// Cada escritor alterna 'mv' de una carpeta entre dos padres (en ArbolJerarquia cada mv reconstruye
+// los índices completos, de modo que el candado exclusivo se mantiene durante toda la reconstrucción).
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+#include "concurrente.hpp"
+#include "persistente.hpp"
+
+using Reloj = chrono::steady_clock;
+
+struct Percentiles {
+    size_t muestras = 0;
+    double p50 = 0, p99 = 0, p999 = 0, max = 0; // Nanosegundos
+    size_t escrituras = 0;
+};
+
+static Percentiles calcular(vector<uint32_t>& latencias, size_t escrituras) {
+    Percentiles p;
+    p.muestras = latencias.size();
+    p.escrituras = escrituras;
+    if (latencias.empty()) return p;
+    sort(latencias.begin(), latencias.end());
+    auto en = [&](double q) { return double(latencias[min(latencias.size() - 1, size_t(q * latencias.size()))]); };
+    p.p50 = en(0.50);
+    p.p99 = en(0.99);
+    p.p999 = en(0.999);
+    p.max = latencias.back();
+    return p;
+}
+
+// Ejecuta 'lectores' hilos llamando a leer(ruta) y 'escritores' hilos llamando a escribir(i)
+template <typename Leer, typename Escribir>
+static Percentiles medir(int lectores, int escritores, double segundos, const vector<string>& rutas,
+                         Leer leer, Escribir escribir) {
+    atomic<bool> parar{false};
+    atomic<size_t> escrituras{0};
+    vector<vector<uint32_t>> latencias(lectores);
+    vector<thread> hilos;
+
+    for (int l = 0; l < lectores; ++l) {
+        hilos.emplace_back([&, l] {
+            mt19937 gen(99 + l);
+            uniform_int_distribution<size_t> elegir(0, rutas.size() - 1);
+            vector<uint32_t>& mias = latencias[l];
+            mias.reserve(1 << 22);
+            while (!parar.load(memory_order_relaxed)) {
+                const string& ruta = rutas[elegir(gen)];
+                auto t0 = Reloj::now();
+                leer(ruta);
+                auto t1 = Reloj::now();
+                if (mias.size() < mias.capacity()) {
+                    mias.push_back(uint32_t(min<long long>(UINT32_MAX,
+                        chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count())));
+                }
+            }
+        });
+    }
+    for (int e = 0; e < escritores; ++e) {
+        hilos.emplace_back([&, e] {
+            size_t i = 0;
+            while (!parar.load(memory_order_relaxed)) {
+                escribir(e, i++);
+                escrituras.fetch_add(1, memory_order_relaxed);
+            }
+        });
+    }
+
+    this_thread::sleep_for(chrono::duration<double>(segundos));
+    parar.store(true);
+    for (thread& t : hilos) t.join();
+
+    vector<uint32_t> todas;
+    for (auto& v : latencias) todas.insert(todas.end(), v.begin(), v.end());
+    return calcular(todas, escrituras.load());
+}
+
+static void imprimir(const string& etiqueta, const Percentiles& p) {
+    cout << left << setw(34) << etiqueta << right
+         << setw(12) << p.muestras
+         << setw(10) << fixed << setprecision(0) << p.p50
+         << setw(10) << p.p99
+         << setw(12) << p.p999
+         << setw(14) << p.max
+         << setw(12) << p.escrituras << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int lectores = argc > 1 ? atoi(argv[1]) : 2;
+    int escritores = argc > 2 ? atoi(argv[2]) : 1;
+    double segundos = argc > 3 ? atof(argv[3]) : 1.0;
+    int carpetas = argc > 4 ? atoi(argv[4]) : 200;
+    int archivos = argc > 5 ? atoi(argv[5]) : 200;
+
+    streambuf* salida_original = cout.rdbuf(nullptr);
+    streambuf* errores_original = cerr.rdbuf(nullptr);
+
+    // Árbol base: /dN/fM más /mover/wE (lo que mueven los escritores) y /alterno
+    ArbolConcurrente concurrente;
+    ArbolJerarquia base;
+    vector<string> rutas;
+    for (int d = 0; d < carpetas; ++d) {
+        string carpeta = "d" + to_string(d);
+        base.crearNodo("/", carpeta, TipoNodo::Carpeta);
+        for (int f = 0; f < archivos; ++f) {
+            string archivo = "f" + to_string(f);
+            base.crearNodo("/" + carpeta, archivo, TipoNodo::Archivo, "x");
+            rutas.push_back("/" + carpeta + "/" + archivo);
+        }
+    }
+    base.crearNodo("/", "mover", TipoNodo::Carpeta);
+    base.crearNodo("/", "alterno", TipoNodo::Carpeta);
+    for (int e = 0; e < escritores; ++e) base.crearNodo("/mover", "w" + to_string(e), TipoNodo::Carpeta);
+    base.guardar("bench_persistente.json");
+    concurrente.cargar("bench_persistente.json");
+    remove("bench_persistente.json");
+
+    ArbolPersistente persistente;
+    persistente.cargarDesde(base);
+
+    // El escritor e mueve /mover/wE a /alterno y de vuelta
+    auto destino = [](size_t i) { return i % 2 == 0 ? "/alterno" : "/mover"; };
+    auto origen = [](int e, size_t i) { return string(i % 2 == 0 ? "/mover/w" : "/alterno/w") + to_string(e); };
+
+    auto leer_concurrente = [&](const string& ruta) {
+        volatile bool encontrado = concurrente.existe(ruta);
+        (void)encontrado;
+    };
+    auto leer_persistente = [&](const string& ruta) {
+        Instantanea s = persistente.instantanea();
+        volatile bool encontrado = s.buscar(ruta) != nullptr;
+        (void)encontrado;
+    };
+
+    Percentiles c0 = medir(lectores, 0, segundos, rutas, leer_concurrente, [](int, size_t) {});
+    Percentiles c1 = medir(lectores, escritores, segundos, rutas, leer_concurrente,
+                           [&](int e, size_t i) { concurrente.moverNodo(origen(e, i), destino(i)); });
+    Percentiles p0 = medir(lectores, 0, segundos, rutas, leer_persistente, [](int, size_t) {});
+    Percentiles p1 = medir(lectores, escritores, segundos, rutas, leer_persistente,
+                           [&](int e, size_t i) { persistente.moverNodo(origen(e, i), destino(i)); });
+
+    cout.rdbuf(salida_original);
+    cerr.rdbuf(errores_original);
+
+    cout << "Lectura de ruta con " << lectores << " lectores, " << escritores << " escritores (mv), arbol de "
+         << carpetas << "x" << archivos << " archivos, " << segundos << " s por escenario" << endl;
+    cout << left << setw(34) << "escenario" << right << setw(12) << "lecturas" << setw(10) << "p50 ns"
+         << setw(10) << "p99 ns" << setw(12) << "p99.9 ns" << setw(14) << "max ns" << setw(12) << "escrituras" << endl;
+    imprimir("concurrente, sin escritores", c0);
+    imprimir("concurrente, con escritores", c1);
+    imprimir("persistente, sin escritores", p0);
+    imprimir("persistente, con escritores", p1);
+    cout << "Nodos retirados pendientes al final: " << persistente.pendientesDeLiberar() << endl;
+    return 0;
+}
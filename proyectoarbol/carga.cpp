@@ -0,0 +1,151 @@
+// Generador de carga para el servidor de proyectoarbol.
+//
+// Uso: carga [-s socket] [-c conexiones] [-p peticiones_en_vuelo] [-d segundos] [-f archivo_comandos]
+// Cada conexión mantiene hasta -p peticiones encadenadas; los comandos se toman en rueda del archivo
+// (una línea por comando) o, por defecto, de una mezcla de solo lectura (ls / search / export).
+// Informa peticiones por segundo y la latencia p50/p99/p99.9/max medida desde el envío.
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <cstring>
+#include <cstdlib>
+
+#include "protocolo.hpp"
+
+using namespace std;
+using Reloj = chrono::steady_clock;
+
+struct ResultadoConexion {
+    vector<uint32_t> latencias_us;
+    size_t respuestas = 0;
+    bool error = false;
+};
+
+static void conexion(const string& ruta, const vector<string>& comandos, size_t desfase, int en_vuelo,
+                     const atomic<bool>& parar, ResultadoConexion& res) {
+    int fd = protocolo::conectar(ruta);
+    if (fd < 0) {
+        res.error = true;
+        return;
+    }
+
+    deque<Reloj::time_point> envios; // Instante de envío de cada petición sin respuesta, en orden
+    string buffer;
+    size_t pos = 0;
+    size_t siguiente = desfase;
+    char bloque[64 * 1024];
+    res.latencias_us.reserve(1 << 20);
+
+    while (true) {
+        // Rellenar la ventana de peticiones en vuelo
+        if (!parar.load(memory_order_relaxed)) {
+            string lote;
+            while (int(envios.size()) < en_vuelo) {
+                lote += comandos[siguiente++ % comandos.size()];
+                lote += '\n';
+                envios.push_back(Reloj::now());
+            }
+            if (!lote.empty() && !protocolo::enviarTodo(fd, lote)) {
+                res.error = true;
+                break;
+            }
+        } else if (envios.empty()) {
+            break;
+        }
+
+        ssize_t n = recv(fd, bloque, sizeof(bloque), 0);
+        if (n <= 0) {
+            res.error = true;
+            break;
+        }
+        buffer.append(bloque, size_t(n));
+
+        string_view texto;
+        auto ahora = Reloj::now();
+        while (protocolo::extraerRespuesta(buffer, pos, texto)) {
+            auto us = chrono::duration_cast<chrono::microseconds>(ahora - envios.front()).count();
+            envios.pop_front();
+            res.latencias_us.push_back(uint32_t(min<long long>(us, UINT32_MAX)));
+            ++res.respuestas;
+        }
+        buffer.erase(0, pos);
+        pos = 0;
+    }
+    close(fd);
+}
+
+int main(int argc, char* argv[]) {
+    string ruta = protocolo::SOCKET_POR_DEFECTO;
+    int conexiones = 8;
+    int en_vuelo = 16;
+    double segundos = 5.0;
+    string archivo;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string opcion = argv[i];
+        if (opcion == "-s") ruta = argv[i + 1];
+        else if (opcion == "-c") conexiones = max(1, atoi(argv[i + 1]));
+        else if (opcion == "-p") en_vuelo = max(1, atoi(argv[i + 1]));
+        else if (opcion == "-d") segundos = atof(argv[i + 1]);
+        else if (opcion == "-f") archivo = argv[i + 1];
+        else {
+            cerr << "Opcion desconocida: " << opcion << endl;
+            return 1;
+        }
+    }
+
+    vector<string> comandos;
+    if (!archivo.empty()) {
+        ifstream entrada(archivo);
+        string linea;
+        while (getline(entrada, linea)) {
+            if (!linea.empty()) comandos.push_back(linea);
+        }
+    }
+    if (comandos.empty()) {
+        comandos = {"ls /", "search a", "ls /", "search d", "export preorden"};
+    }
+
+    atomic<bool> parar{false};
+    vector<ResultadoConexion> resultados(conexiones);
+    vector<thread> hilos;
+    auto inicio = Reloj::now();
+    for (int c = 0; c < conexiones; ++c) {
+        hilos.emplace_back(conexion, cref(ruta), cref(comandos), size_t(c), en_vuelo, cref(parar), ref(resultados[c]));
+    }
+    this_thread::sleep_for(chrono::duration<double>(segundos));
+    parar.store(true);
+    for (thread& h : hilos) h.join();
+    double transcurrido = chrono::duration<double>(Reloj::now() - inicio).count();
+
+    vector<uint32_t> todas;
+    size_t respuestas = 0, errores = 0;
+    for (ResultadoConexion& r : resultados) {
+        todas.insert(todas.end(), r.latencias_us.begin(), r.latencias_us.end());
+        respuestas += r.respuestas;
+        errores += r.error;
+    }
+    if (todas.empty()) {
+        cerr << "Error: Ninguna respuesta recibida de " << ruta << endl;
+        return 1;
+    }
+    sort(todas.begin(), todas.end());
+    auto percentil = [&](double q) { return todas[min(todas.size() - 1, size_t(q * todas.size()))]; };
+
+    cout << conexiones << " conexiones x " << en_vuelo << " en vuelo, " << fixed << setprecision(1)
+         << transcurrido << " s" << endl;
+    cout << "Peticiones/s: " << setprecision(0) << respuestas / transcurrido << " (" << respuestas << " respuestas";
+    if (errores) cout << ", " << errores << " conexiones con error";
+    cout << ")" << endl;
+    cout << "Latencia (us): p50 " << percentil(0.50) << "  p99 " << percentil(0.99)
+         << "  p99.9 " << percentil(0.999) << "  max " << todas.back() << endl;
+    return errores ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+// Cliente mínimo del servidor de proyectoarbol (ver protocolo.hpp).
+//
+// Uso: cliente [-s socket] [comando ...]
+//  - Con un comando en los argumentos, lo envía y muestra la respuesta.
+//  - Sin argumentos y con la entrada en una terminal, funciona como la consola interactiva.
+//  - Sin argumentos y con la entrada redirigida, envía todas las líneas encadenadas y luego
+//    muestra las respuestas en orden.
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cerrno>
+
+#include "protocolo.hpp"
+
+using namespace std;
+
+// Recibe hasta completar 'cuantas' respuestas y las imprime; false si el servidor cerró antes
+static bool recibirRespuestas(int fd, size_t cuantas) {
+    string buffer;
+    size_t pos = 0;
+    char bloque[64 * 1024];
+    while (cuantas > 0) {
+        string_view texto;
+        while (cuantas > 0 && protocolo::extraerRespuesta(buffer, pos, texto)) {
+            cout << texto;
+            --cuantas;
+        }
+        if (cuantas == 0) break;
+        buffer.erase(0, pos);
+        pos = 0;
+        ssize_t n = recv(fd, bloque, sizeof(bloque), 0);
+        if (n <= 0) return false;
+        buffer.append(bloque, size_t(n));
+    }
+    cout.flush();
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    string ruta = protocolo::SOCKET_POR_DEFECTO;
+    int primero = 1;
+    if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+        ruta = argv[2];
+        primero = 3;
+    }
+
+    int fd = protocolo::conectar(ruta);
+    if (fd < 0) {
+        cerr << "Error: No se pudo conectar con " << ruta << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    if (primero < argc) {
+        string linea;
+        for (int i = primero; i < argc; ++i) {
+            if (i > primero) linea += ' ';
+            linea += argv[i];
+        }
+        bool ok = protocolo::enviarTodo(fd, linea + "\n") && recibirRespuestas(fd, 1);
+        close(fd);
+        return ok ? 0 : 1;
+    }
+
+    string linea;
+    if (isatty(STDIN_FILENO)) {
+        while (true) {
+            cout << "\n> " << flush;
+            if (!getline(cin, linea)) break;
+            if (!protocolo::enviarTodo(fd, linea + "\n") || !recibirRespuestas(fd, 1)) break;
+        }
+        close(fd);
+        return 0;
+    }
+
+    // Entrada redirigida: se encadenan todas las peticiones y después se leen las respuestas
+    size_t enviadas = 0;
+    string lote;
+    while (getline(cin, linea)) {
+        lote += linea;
+        lote += '\n';
+        ++enviadas;
+        if (lote.size() >= 64 * 1024) {
+            if (!protocolo::enviarTodo(fd, lote)) break;
+            lote.clear();
+        }
+    }
+    protocolo::enviarTodo(fd, lote);
+    shutdown(fd, SHUT_WR);
+    bool ok = recibirRespuestas(fd, enviadas);
+    close(fd);
+    return ok ? 0 : 1;
+}
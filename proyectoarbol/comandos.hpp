@@ -0,0 +1,161 @@
+#ifndef COMANDOS_HPP
+#define COMANDOS_HPP
+
+#include <array>
+#include <string_view>
+#include <cstdint>
+#include <charconv>
+
+#include "metricas.hpp"
+
+using namespace std;
+
+// ==============================================
+// LECTURA DE COMANDOS SIN RESERVAS DE MEMORIA
+// ==============================================
+//
+// Una línea se parte en vistas sobre el propio texto (LineaComando) y la primera palabra se resuelve
+// con una tabla hash perfecta construida al compilar (comandos::buscar): ni leer los argumentos ni
+// elegir el comando reserva memoria, así que en modo por lotes el coste es el de la operación.
+
+namespace comandos {
+
+// Un valor por nombre de Metricas::COMANDOS y en el mismo orden: el comando es también el índice de
+// su histograma. Otro = no reconocido.
+enum class Comando : uint8_t {
+    Mkdir, Touch, Mv, Rm, Ls, Rename, Search, Export, Save, Load, Help, Exit,
+    Stats, Mem, Papelera, Restore, ClearTrash, Import, Undo, Redo, Historial, Hash, Diff, Sort, Autosave, Otro
+};
+static_assert(size_t(Comando::Otro) + 1 == Metricas::COMANDOS.size(), "Comando y Metricas::COMANDOS deben coincidir");
+
+constexpr size_t HUECOS = 64; // Potencia de 2, holgada para que la búsqueda de semilla acabe pronto
+
+// FNV-1a a partir de la semilla, plegado a un hueco
+constexpr size_t hueco(string_view palabra, uint32_t semilla) {
+    uint32_t h = 2166136261u ^ semilla;
+    for (char c : palabra) h = (h ^ uint8_t(c)) * 16777619u;
+    return (h ^ (h >> 15)) & (HUECOS - 1);
+}
+
+// Primera semilla con la que ningún par de comandos comparte hueco
+constexpr uint32_t buscarSemilla() {
+    for (uint32_t semilla = 0;; ++semilla) {
+        bool ocupado[HUECOS] = {};
+        bool valida = true;
+        for (size_t i = 0; valida && i < size_t(Comando::Otro); ++i) {
+            size_t h = hueco(Metricas::COMANDOS[i], semilla);
+            valida = !ocupado[h];
+            ocupado[h] = true;
+        }
+        if (valida) return semilla;
+    }
+}
+
+constexpr uint32_t SEMILLA = buscarSemilla();
+
+constexpr array<Comando, HUECOS> construirTabla() {
+    array<Comando, HUECOS> tabla{};
+    for (Comando& c : tabla) c = Comando::Otro;
+    for (size_t i = 0; i < size_t(Comando::Otro); ++i) tabla[hueco(Metricas::COMANDOS[i], SEMILLA)] = Comando(i);
+    return tabla;
+}
+
+constexpr array<Comando, HUECOS> TABLA = construirTabla();
+
+// Un hash y una comparación: el hueco solo puede ser de este comando
+constexpr Comando buscar(string_view palabra) {
+    Comando c = TABLA[hueco(palabra, SEMILLA)];
+    return (c != Comando::Otro && palabra == Metricas::COMANDOS[size_t(c)]) ? c : Comando::Otro;
+}
+
+static_assert(buscar("mkdir") == Comando::Mkdir && buscar("sort") == Comando::Sort && buscar("otro") == Comando::Otro &&
+              buscar("") == Comando::Otro, "Tabla de comandos mal construida");
+
+// Entero sin signo en decimal que ocupa toda la palabra
+inline bool numero(string_view palabra, uint64_t& valor) {
+    const char* fin = palabra.data() + palabra.size();
+    auto [p, error] = from_chars(palabra.data(), fin, valor);
+    return !palabra.empty() && error == errc() && p == fin;
+}
+
+} // namespace comandos
+
+/**
+ * @brief Una línea de comando partida en palabras sin copiar nada: cada palabra es una vista de la línea.
+ * * Separan espacios, tabuladores y '\r'. Una palabra que empieza por comillas (dobles o simples) llega
+ *   hasta las siguientes del mismo tipo y puede llevar espacios: mkdir / "mi carpeta". Las comillas no
+ *   forman parte de la palabra y no hay secuencias de escape.
+ * * Se guardan las MAX_PALABRAS primeras; las demás siguen disponibles con resto() (contenido de 'touch').
+ */
+class LineaComando {
+public:
+    static constexpr size_t MAX_PALABRAS = 16;
+
+private:
+    struct Palabra {
+        string_view texto;
+        uint32_t inicio; // En la línea, comillas incluidas
+        uint32_t fin;
+        bool citada;
+    };
+
+    string_view linea;
+    Palabra palabras[MAX_PALABRAS]; // Solo las 'cantidad' primeras tienen valor
+    size_t cantidad = 0;
+    bool sin_cerrar = false;
+
+    static bool esBlanco(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+public:
+    explicit LineaComando(string_view l) : linea(l) {
+        size_t i = 0, n = linea.size();
+        while (cantidad < MAX_PALABRAS) {
+            while (i < n && esBlanco(linea[i])) ++i;
+            if (i == n) break;
+            Palabra& p = palabras[cantidad++];
+            p.inicio = uint32_t(i);
+            if (linea[i] == '"' || linea[i] == '\'') {
+                size_t cierre = linea.find(linea[i], i + 1);
+                if (cierre == string_view::npos) {
+                    sin_cerrar = true;
+                    cierre = n;
+                }
+                p.texto = linea.substr(i + 1, cierre - i - 1);
+                p.citada = true;
+                i = min(cierre + 1, n);
+            } else {
+                size_t fin = i;
+                while (fin < n && !esBlanco(linea[fin])) ++fin;
+                p.texto = linea.substr(i, fin - i);
+                p.citada = false;
+                i = fin;
+            }
+            p.fin = uint32_t(i);
+        }
+    }
+
+    size_t size() const { return cantidad; }
+    bool empty() const { return cantidad == 0; }
+
+    // Palabra 'i' (vacía si no la hay)
+    string_view operator[](size_t i) const { return i < cantidad ? palabras[i].texto : string_view(); }
+
+    // false si unas comillas quedaron sin cerrar
+    bool valida() const { return !sin_cerrar; }
+
+    /**
+     * @brief El texto desde la palabra 'i' hasta el final, tal cual (sin los blancos del final).
+     * * Si ese texto es una sola palabra entre comillas, su contenido: así se conservan también
+     *   los espacios del principio y del final.
+     */
+    string_view resto(size_t i) const {
+        if (i >= cantidad) return {};
+        const Palabra& p = palabras[i];
+        size_t fin = linea.size();
+        while (fin > p.inicio && esBlanco(linea[fin - 1])) --fin;
+        if (p.citada && fin <= p.fin) return p.texto;
+        return linea.substr(p.inicio, fin - p.inicio);
+    }
+};
+
+#endif // COMANDOS_HPP
@@ -0,0 +1,494 @@
+#ifndef COMPACTO_HPP
+#define COMPACTO_HPP
+
+#include <cstdint>
+
+#include "arbol.hpp"
+
+// ==============================================
+// ÁRBOL COMPACTO (estructura de arrays)
+// ==============================================
+
+/**
+ * @brief Árbol guardado como arrays paralelos indexados por un Id de 32 bits, sin un objeto por nodo.
+ * * Cada nodo es una posición en padre / primer_hijo / siguiente_hermano / nombre / tipo / contenido:
+ *   17 bytes por nodo en los arrays que tocan las rutas y los recorridos, frente a los 32 de la parte
+ *   caliente de Nodo (en los bloques de PoolNodos) más su lista de hijos, que está en otro sitio del
+ *   heap. El texto de los archivos y el id persistente van aparte (datos fríos, como DatosNodo) y
+ *   solo se leen al pedirlos.
+ * * Los hijos forman una lista enlazada por siguiente_hermano en orden de creación, como Nodo::hijos.
+ * * compactar() renumera los nodos en preorden: a partir de ahí recorrer el árbol es leer los arrays
+ *   casi en secuencia, y el prefetch del hardware (más el explícito de recorrerPreorden) hace el resto.
+ *   Las altas posteriores van a huecos libres o al final hasta la siguiente compactación.
+ * * Ofrece las operaciones de ArbolJerarquia sobre rutas (sin papelera, historial ni índices
+ *   globales) y el mismo formato JSON; los errores se escriben en cerr, como en ArbolPersistente.
+ */
+class ArbolCompacto {
+public:
+    using Id = uint32_t;
+    static constexpr Id NINGUNO = UINT32_MAX;
+    static constexpr Id RAIZ = 0;
+
+    /**
+     * @brief Cifras de un subárbol (ver resumen()).
+     */
+    struct Resumen {
+        size_t carpetas = 0;
+        size_t archivos = 0;
+        size_t bytes_contenido = 0;
+        size_t profundidad_max = 0; // La raíz del subárbol está a profundidad 0
+    };
+
+private:
+    static constexpr uint8_t LIBRE = 0xff;          // Valor de 'tipo' en un hueco
+    static constexpr uint32_t SIN_CONTENIDO = UINT32_MAX;
+
+    // Datos calientes
+    vector<Id> padre;
+    vector<Id> primer_hijo;
+    vector<Id> siguiente_hermano;
+    vector<Simbolo> nombre;
+    vector<uint8_t> tipo;           // TipoNodo, o LIBRE
+    vector<uint32_t> contenido;     // Posición en 'contenidos', o SIN_CONTENIDO si está vacío
+
+    // Datos fríos
+    vector<string> contenidos;
+    vector<string> ids;
+    vector<Id> libres;              // Huecos de nodos eliminados
+    vector<uint32_t> contenidos_libres;
+
+    Id reservar(Simbolo s, TipoNodo t, const string& texto, string id) {
+        Id n;
+        if (!libres.empty()) {
+            n = libres.back();
+            libres.pop_back();
+        } else {
+            if (tipo.size() >= NINGUNO) throw length_error("ArbolCompacto: demasiados nodos");
+            n = Id(tipo.size());
+            padre.push_back(NINGUNO);
+            primer_hijo.push_back(NINGUNO);
+            siguiente_hermano.push_back(NINGUNO);
+            nombre.push_back(s);
+            tipo.push_back(0);
+            contenido.push_back(SIN_CONTENIDO);
+            ids.emplace_back();
+        }
+        padre[n] = primer_hijo[n] = siguiente_hermano[n] = NINGUNO;
+        nombre[n] = s;
+        tipo[n] = uint8_t(t);
+        contenido[n] = SIN_CONTENIDO;
+        if (!texto.empty()) {
+            if (!contenidos_libres.empty()) {
+                contenido[n] = contenidos_libres.back();
+                contenidos_libres.pop_back();
+                contenidos[contenido[n]] = texto;
+            } else {
+                contenido[n] = uint32_t(contenidos.size());
+                contenidos.push_back(texto);
+            }
+        }
+        ids[n] = std::move(id);
+        return n;
+    }
+
+    // Devuelve al hueco libre 'n' y todo su subárbol (ya desenganchado)
+    void liberarSubarbol(Id n) {
+        vector<Id> pila{n};
+        while (!pila.empty()) {
+            Id actual = pila.back();
+            pila.pop_back();
+            for (Id h = primer_hijo[actual]; h != NINGUNO; h = siguiente_hermano[h]) pila.push_back(h);
+            if (contenido[actual] != SIN_CONTENIDO) {
+                string().swap(contenidos[contenido[actual]]);
+                contenidos_libres.push_back(contenido[actual]);
+            }
+            string().swap(ids[actual]);
+            tipo[actual] = LIBRE;
+            libres.push_back(actual);
+        }
+    }
+
+    // Hijo de 'p' con ese símbolo y, de paso, el último hijo (para añadir detrás)
+    Id hijoConSimbolo(Id p, Simbolo s, Id* ultimo = nullptr) const {
+        Id anterior = NINGUNO;
+        for (Id h = primer_hijo[p]; h != NINGUNO; anterior = h, h = siguiente_hermano[h]) {
+            Id sig = siguiente_hermano[h];
+            if (sig != NINGUNO) __builtin_prefetch(&nombre[sig]);
+            if (nombre[h] == s) return h;
+        }
+        if (ultimo) *ultimo = anterior;
+        return NINGUNO;
+    }
+
+    void enganchar(Id n, Id p) {
+        Id ultimo = NINGUNO;
+        if (primer_hijo[p] != NINGUNO) {
+            ultimo = primer_hijo[p];
+            while (siguiente_hermano[ultimo] != NINGUNO) ultimo = siguiente_hermano[ultimo];
+        }
+        (ultimo == NINGUNO ? primer_hijo[p] : siguiente_hermano[ultimo]) = n;
+        padre[n] = p;
+        siguiente_hermano[n] = NINGUNO;
+    }
+
+    void desenganchar(Id n) {
+        Id p = padre[n];
+        if (primer_hijo[p] == n) {
+            primer_hijo[p] = siguiente_hermano[n];
+        } else {
+            Id h = primer_hijo[p];
+            while (siguiente_hermano[h] != n) h = siguiente_hermano[h];
+            siguiente_hermano[h] = siguiente_hermano[n];
+        }
+        padre[n] = siguiente_hermano[n] = NINGUNO;
+    }
+
+    // true si 'nombre_hijo' ya está entre los hijos de 'p' (sin contar 'excepto')
+    bool existeHermano(Id p, string_view nombre_hijo, Id excepto = NINGUNO) const {
+        Simbolo s = TablaSimbolos::global().buscar(nombre_hijo);
+        if (s == SIN_SIMBOLO) return false;
+        Id h = hijoConSimbolo(p, s);
+        return h != NINGUNO && h != excepto;
+    }
+
+    void vaciar() {
+        padre.clear();
+        primer_hijo.clear();
+        siguiente_hermano.clear();
+        nombre.clear();
+        tipo.clear();
+        contenido.clear();
+        contenidos.clear();
+        ids.clear();
+        libres.clear();
+        contenidos_libres.clear();
+    }
+
+    // Al construir en bloque: cuelga 'h' de 'p' detrás de 'anterior' (su último hijo hasta ahora)
+    void encadenar(Id h, Id p, Id& anterior) {
+        (anterior == NINGUNO ? primer_hijo[p] : siguiente_hermano[anterior]) = h;
+        padre[h] = p;
+        anterior = h;
+    }
+
+    // Crea en preorden el nodo JSON 'j' y sus hijos
+    Id desdeJson(const json& j) {
+        TipoNodo t = (j["tipo"] == "carpeta" ? TipoNodo::Carpeta : TipoNodo::Archivo);
+        string texto_nombre = j["nombre"];
+        Id n = reservar(TablaSimbolos::global().internar(texto_nombre), t, j.value("contenido", ""), j["id"]);
+        if (j.contains("hijos")) {
+            Id anterior = NINGUNO;
+            for (const auto& j_hijo : j["hijos"]) encadenar(desdeJson(j_hijo), n, anterior);
+        }
+        return n;
+    }
+
+    Id copiar(const Nodo* nodo) {
+        Id n = reservar(nodo->nombre.simbolo(), nodo->tipo, nodo->contenido(), nodo->id());
+        Id anterior = NINGUNO;
+        for (const Nodo* hijo : nodo->hijos) encadenar(copiar(hijo), n, anterior);
+        return n;
+    }
+
+    json aJson(Id n) const {
+        json j;
+        j["id"] = ids[n];
+        j["nombre"] = string(TablaSimbolos::global().texto(nombre[n]));
+        j["tipo"] = (TipoNodo(tipo[n]) == TipoNodo::Carpeta ? "carpeta" : "archivo");
+        j["contenido"] = string(textoDe(n));
+        json j_hijos = json::array();
+        for (Id h = primer_hijo[n]; h != NINGUNO; h = siguiente_hermano[h]) j_hijos.push_back(aJson(h));
+        j["hijos"] = j_hijos;
+        return j;
+    }
+
+public:
+    ArbolCompacto() {
+        reservar(TablaSimbolos::global().internar("/"), TipoNodo::Carpeta, "", Nodo::generarId("/"));
+    }
+
+    // --- Lectura ---
+
+    /**
+     * @brief Id del nodo de una ruta, o NINGUNO si no existe.
+     */
+    Id obtenerNodo(string_view ruta) const {
+        Id actual = RAIZ;
+        size_t i = 0;
+        while (true) {
+            while (i < ruta.size() && ruta[i] == '/') ++i;
+            if (i == ruta.size()) return actual;
+            size_t inicio = i;
+            while (i < ruta.size() && ruta[i] != '/') ++i;
+            Simbolo s = TablaSimbolos::global().buscar(ruta.substr(inicio, i - inicio));
+            if (s == SIN_SIMBOLO) return NINGUNO;
+            actual = hijoConSimbolo(actual, s);
+            if (actual == NINGUNO) return NINGUNO;
+        }
+    }
+
+    string_view nombreDe(Id n) const { return TablaSimbolos::global().texto(nombre[n]); }
+    TipoNodo tipoDe(Id n) const { return TipoNodo(tipo[n]); }
+    string_view textoDe(Id n) const { return contenido[n] == SIN_CONTENIDO ? string_view() : contenidos[contenido[n]]; }
+    Id padreDe(Id n) const { return padre[n]; }
+
+    size_t tamano() const { return tipo.size() - libres.size(); }
+
+    /**
+     * @brief Recorre los hijos directos de una carpeta; devuelve false si la ruta no es una carpeta.
+     */
+    template <typename Visitante>
+    bool visitarHijos(string_view ruta, Visitante visitante) const {
+        Id n = obtenerNodo(ruta);
+        if (n == NINGUNO || TipoNodo(tipo[n]) != TipoNodo::Carpeta) return false;
+        for (Id h = primer_hijo[n]; h != NINGUNO; h = siguiente_hermano[h]) visitante(h);
+        return true;
+    }
+
+    /**
+     * @brief Preorden del subárbol de 'raiz_subarbol' sin pila: se baja por primer_hijo y se sube por
+     *        padre hasta encontrar un siguiente_hermano. Llama a visitante(id, profundidad).
+     * * Antes de visitar un nodo se adelanta la lectura de su primer hijo y de su siguiente hermano,
+     *   los dos candidatos a ser el próximo; tras compactar() suelen estar ya en la misma línea.
+     */
+    template <typename Visitante>
+    void recorrerPreorden(Id raiz_subarbol, Visitante visitante) const {
+        Id n = raiz_subarbol;
+        size_t profundidad = 0;
+        while (true) {
+            Id hijo = primer_hijo[n], hermano = siguiente_hermano[n];
+            if (hijo != NINGUNO) {
+                __builtin_prefetch(&primer_hijo[hijo]);
+                __builtin_prefetch(&nombre[hijo]);
+            }
+            if (hermano != NINGUNO) __builtin_prefetch(&primer_hijo[hermano]);
+            visitante(n, profundidad);
+            if (hijo != NINGUNO) {
+                n = hijo;
+                ++profundidad;
+                continue;
+            }
+            while (n != raiz_subarbol && siguiente_hermano[n] == NINGUNO) {
+                n = padre[n];
+                --profundidad;
+            }
+            if (n == raiz_subarbol) return;
+            n = siguiente_hermano[n];
+        }
+    }
+
+    /**
+     * @brief Carpetas, archivos, bytes de contenido y profundidad de un subárbol.
+     * * Para la raíz no hace falta recorrer nada: basta una pasada secuencial por 'tipo' y 'contenido'
+     *   (la profundidad sí necesita el recorrido).
+     */
+    bool resumen(string_view ruta, Resumen& r, bool con_profundidad = false) const {
+        Id n = obtenerNodo(ruta);
+        if (n == NINGUNO) return false;
+        r = Resumen();
+        auto contar = [&](Id id) {
+            ++(TipoNodo(tipo[id]) == TipoNodo::Carpeta ? r.carpetas : r.archivos);
+            if (contenido[id] != SIN_CONTENIDO) r.bytes_contenido += contenidos[contenido[id]].size();
+        };
+        if (n == RAIZ && !con_profundidad) {
+            for (Id id = 0; id < tipo.size(); ++id) {
+                if (tipo[id] != LIBRE) contar(id);
+            }
+            return true;
+        }
+        recorrerPreorden(n, [&](Id id, size_t profundidad) {
+            contar(id);
+            r.profundidad_max = max(r.profundidad_max, profundidad);
+        });
+        return true;
+    }
+
+    /**
+     * @brief Lista de nodos en preorden, en el formato de ArbolJerarquia::exportarPreorden.
+     * * La ruta se mantiene en un único buffer que crece y se recorta con la profundidad.
+     */
+    vector<string> exportarPreorden() const {
+        vector<string> resultado;
+        resultado.reserve(tamano());
+        resultado.push_back("[C] /");
+        string ruta;
+        vector<size_t> largos; // largos[d]: longitud de 'ruta' hasta el nodo a profundidad d
+        recorrerPreorden(RAIZ, [&](Id n, size_t profundidad) {
+            if (profundidad == 0) return;
+            largos.resize(profundidad);
+            ruta.resize(profundidad > 1 ? largos[profundidad - 2] : 0);
+            ruta += '/';
+            ruta += nombreDe(n);
+            largos[profundidad - 1] = ruta.size();
+            resultado.push_back((TipoNodo(tipo[n]) == TipoNodo::Carpeta ? "[C] " : "[A] ") + ruta);
+        });
+        return resultado;
+    }
+
+    // --- Escritura ---
+
+    bool crearNodo(string_view ruta_padre, const string& nombre_nuevo, TipoNodo t, const string& texto = "") {
+        Id p = obtenerNodo(ruta_padre);
+        if (p == NINGUNO || TipoNodo(tipo[p]) != TipoNodo::Carpeta) {
+            cerr << "Error: Ruta padre '" << ruta_padre << "' no encontrada o no es una carpeta." << endl;
+            return false;
+        }
+        Simbolo s = TablaSimbolos::global().internar(nombre_nuevo);
+        Id ultimo = NINGUNO;
+        if (hijoConSimbolo(p, s, &ultimo) != NINGUNO) {
+            cerr << "Error: Ya existe un nodo con el nombre '" << nombre_nuevo << "' en esta ruta." << endl;
+            return false;
+        }
+        Id n = reservar(s, t, texto, Nodo::generarId(nombre_nuevo));
+        (ultimo == NINGUNO ? primer_hijo[p] : siguiente_hermano[ultimo]) = n;
+        padre[n] = p;
+        return true;
+    }
+
+    bool renombrarNodo(string_view ruta, const string& nuevo_nombre) {
+        Id n = obtenerNodo(ruta);
+        if (n == NINGUNO || n == RAIZ) {
+            cerr << "Error: Nodo no encontrado o es la raiz ('/')." << endl;
+            return false;
+        }
+        if (existeHermano(padre[n], nuevo_nombre, n)) {
+            cerr << "Error: Ya existe un nodo con el nombre '" << nuevo_nombre << "' en este directorio." << endl;
+            return false;
+        }
+        nombre[n] = TablaSimbolos::global().internar(nuevo_nombre);
+        return true;
+    }
+
+    bool eliminarNodo(string_view ruta) {
+        Id n = obtenerNodo(ruta);
+        if (n == NINGUNO || n == RAIZ) {
+            cerr << "Error: Nodo no encontrado o es la raiz ('/')." << endl;
+            return false;
+        }
+        desenganchar(n);
+        liberarSubarbol(n);
+        return true;
+    }
+
+    bool moverNodo(string_view ruta_origen, string_view ruta_destino) {
+        Id n = obtenerNodo(ruta_origen);
+        if (n == NINGUNO || n == RAIZ) {
+            cerr << "Error: Nodo de origen no encontrado o es la raiz." << endl;
+            return false;
+        }
+        Id destino = obtenerNodo(ruta_destino);
+        if (destino == NINGUNO || TipoNodo(tipo[destino]) != TipoNodo::Carpeta) {
+            cerr << "Error: Destino no encontrado o no es una carpeta." << endl;
+            return false;
+        }
+        for (Id a = destino; a != NINGUNO; a = padre[a]) {
+            if (a == n) {
+                cerr << "Error: No se puede mover una carpeta a un subdirectorio propio." << endl;
+                return false;
+            }
+        }
+        if (existeHermano(destino, nombreDe(n), n)) {
+            cerr << "Error: Ya existe un nodo con el nombre '" << nombreDe(n) << "' en el destino." << endl;
+            return false;
+        }
+        desenganchar(n);
+        enganchar(n, destino);
+        return true;
+    }
+
+    /**
+     * @brief Renumera los nodos en preorden y elimina los huecos (también los de contenidos).
+     * * Los Id anteriores dejan de valer.
+     */
+    void compactar() {
+        vector<Id> orden; // orden[nuevo] = viejo
+        orden.reserve(tamano());
+        recorrerPreorden(RAIZ, [&](Id n, size_t) { orden.push_back(n); });
+        vector<Id> nuevo_id(tipo.size(), NINGUNO);
+        for (Id i = 0; i < orden.size(); ++i) nuevo_id[orden[i]] = i;
+        auto traducir = [&](Id viejo) { return viejo == NINGUNO ? NINGUNO : nuevo_id[viejo]; };
+
+        ArbolCompacto c;
+        c.vaciar();
+        size_t n = orden.size();
+        c.padre.resize(n);
+        c.primer_hijo.resize(n);
+        c.siguiente_hermano.resize(n);
+        c.nombre.resize(n);
+        c.tipo.resize(n);
+        c.contenido.resize(n);
+        c.ids.resize(n);
+        for (Id i = 0; i < n; ++i) {
+            Id viejo = orden[i];
+            c.padre[i] = traducir(padre[viejo]);
+            c.primer_hijo[i] = traducir(primer_hijo[viejo]);
+            c.siguiente_hermano[i] = traducir(siguiente_hermano[viejo]);
+            c.nombre[i] = nombre[viejo];
+            c.tipo[i] = tipo[viejo];
+            c.ids[i] = std::move(ids[viejo]);
+            c.contenido[i] = SIN_CONTENIDO;
+            if (contenido[viejo] != SIN_CONTENIDO) {
+                c.contenido[i] = uint32_t(c.contenidos.size());
+                c.contenidos.push_back(std::move(contenidos[contenido[viejo]]));
+            }
+        }
+        *this = std::move(c);
+    }
+
+    // --- Persistencia (mismo formato que ArbolJerarquia) ---
+
+    bool guardar(const string& nombre_archivo = "jerarquia.json") const {
+        try {
+            escribirJsonAtomico(aJson(RAIZ), nombre_archivo); // Lanza si no se pudo escribir
+            return true;
+        } catch (const exception& e) {
+            cerr << "Error al guardar el JSON: " << e.what() << endl;
+            return false;
+        }
+    }
+
+    bool cargar(const string& nombre_archivo = "jerarquia.json") {
+        try {
+            ifstream i(nombre_archivo);
+            if (!i.is_open()) {
+                cerr << "Advertencia: Archivo " << nombre_archivo << " no encontrado." << endl;
+                return false;
+            }
+            json j;
+            i >> j;
+            // Se construye aparte: si el JSON falla a medias, el árbol actual queda intacto
+            ArbolCompacto nuevo;
+            nuevo.vaciar();
+            nuevo.desdeJson(j); // Ya en preorden
+            *this = std::move(nuevo);
+            return true;
+        } catch (const exception& e) {
+            cerr << "Error al cargar/parsear el JSON: " << e.what() << endl;
+            return false;
+        }
+    }
+
+    /**
+     * @brief Copia el contenido actual de un ArbolJerarquia, ya en preorden.
+     */
+    void cargarDesde(const ArbolJerarquia& arbol) {
+        vaciar();
+        copiar(arbol.obtenerNodo("/"));
+    }
+
+    /**
+     * @brief Bytes pedidos al asignador: los arrays por su capacidad más el texto fuera de línea.
+     */
+    size_t bytes() const {
+        size_t total = sizeof(ArbolCompacto) + memoria::bytesVector(padre) + memoria::bytesVector(primer_hijo) +
+                       memoria::bytesVector(siguiente_hermano) + memoria::bytesVector(nombre) +
+                       memoria::bytesVector(tipo) + memoria::bytesVector(contenido) +
+                       memoria::bytesVector(contenidos) + memoria::bytesVector(ids) + memoria::bytesVector(libres) +
+                       memoria::bytesVector(contenidos_libres);
+        for (const string& s : contenidos) total += memoria::bytesString(s);
+        for (const string& s : ids) total += memoria::bytesString(s);
+        return total;
+    }
+};
+
+#endif // COMPACTO_HPP
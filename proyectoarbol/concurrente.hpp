@@ -0,0 +1,215 @@
+#ifndef CONCURRENTE_HPP
+#define CONCURRENTE_HPP
+
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <exception>
+
+#include "arbol.hpp"
+
+// ==============================================
+// MODO CONCURRENTE: ArbolConcurrente
+// ==============================================
+
+/**
+ * @brief Envoltorio de ArbolJerarquia para uso desde varios hilos.
+ * * Lecturas (rutas, ls, búsquedas) toman un candado compartido y no reservan memoria.
+ * * Escrituras se combinan en lotes: el hilo que consigue el candado exclusivo ejecuta
+ *   también las operaciones encoladas por los demás y reconstruye los índices una sola vez.
+ */
+class ArbolConcurrente {
+public:
+    // Operación de escritura: recibe el árbol ya protegido por el candado exclusivo
+    using Operacion = function<bool(ArbolJerarquia&)>;
+
+private:
+    // Solicitud pendiente de un escritor (vive en la pila del hilo que la encola)
+    struct Solicitud {
+        const Operacion* operacion;
+        bool resultado = false;
+        bool hecha = false;
+        exception_ptr error; // Lo que lanzó la operación; se relanza en el hilo que la encoló
+    };
+
+    ArbolJerarquia arbol;
+    mutable shared_mutex mutex_arbol; // Protege árbol, Trie, mapa exacto y papelera
+
+    mutex mutex_cola;                 // Protege la cola de escrituras y el estado de combinación
+    condition_variable cola_atendida;
+    vector<Solicitud*> cola;
+    vector<Solicitud*> lote_actual;   // Se reutiliza entre lotes para no reservar cada vez
+    bool combinando = false;
+    size_t lotes_ejecutados = 0;
+    size_t escrituras_ejecutadas = 0;
+
+public:
+    ArbolConcurrente() = default;
+    ArbolConcurrente(const ArbolConcurrente&) = delete;
+    ArbolConcurrente& operator=(const ArbolConcurrente&) = delete;
+
+    // --- Acceso genérico ---
+
+    /**
+     * @brief Ejecuta f(const ArbolJerarquia&) bajo candado compartido y devuelve su resultado.
+     * * Los punteros a Nodo obtenidos dentro de f no deben usarse fuera de f.
+     * * Con otros lectores a la vez, f puede usar: las consultas de solo lectura de ArbolJerarquia
+     *   (obtenerNodo, visitarHijos, visitarPrefijo, buscarExacto...), medirMemoria, hashDe y los
+     *   métodos const de Nodo, incluidos obtenerHash y aJson (el hash pendiente se rellena con su
+     *   propio mutex). Los que escriben en los flujos de salida o de errores del árbol (ls, hashDe
+     *   con una ruta inexistente...) necesitan flujos que admitan escrituras concurrentes.
+     * * guardar() es const pero no va aquí: dos guardados al mismo archivo comparten el temporal.
+     */
+    template <typename F>
+    auto leer(F&& f) const {
+        shared_lock<shared_mutex> candado(mutex_arbol);
+        return f(static_cast<const ArbolJerarquia&>(arbol));
+    }
+
+    /**
+     * @brief Encola una escritura y espera a que se aplique (posiblemente dentro del lote de otro hilo).
+     * * Si la operación lanza una excepción, se relanza aquí (en el hilo que la encoló); las demás
+     *   operaciones del lote se aplican igual y el lote se cierra siempre.
+     */
+    bool escribir(const Operacion& operacion) {
+        Solicitud solicitud{&operacion, false, false, nullptr};
+        unique_lock<mutex> candado_cola(mutex_cola);
+        cola.push_back(&solicitud);
+
+        while (!solicitud.hecha) {
+            if (combinando) {
+                cola_atendida.wait(candado_cola);
+                continue;
+            }
+
+            // Este hilo pasa a combinar: toma todo lo encolado hasta ahora
+            combinando = true;
+            lote_actual.swap(cola);
+            candado_cola.unlock();
+            {
+                unique_lock<shared_mutex> candado(mutex_arbol);
+                arbol.iniciarLote();
+                for (Solicitud* s : lote_actual) {
+                    try {
+                        s->resultado = (*s->operacion)(arbol);
+                    } catch (...) {
+                        s->error = current_exception();
+                    }
+                }
+                try {
+                    arbol.finalizarLote();
+                } catch (...) { // La reconstrucción de índices del lote: afecta a todas sus operaciones
+                    exception_ptr error = current_exception();
+                    for (Solicitud* s : lote_actual) {
+                        if (!s->error) s->error = error;
+                    }
+                }
+            }
+            candado_cola.lock();
+
+            ++lotes_ejecutados;
+            escrituras_ejecutadas += lote_actual.size();
+            for (Solicitud* s : lote_actual) s->hecha = true;
+            lote_actual.clear();
+            combinando = false;
+            cola_atendida.notify_all();
+        }
+        if (solicitud.error) rethrow_exception(solicitud.error);
+        return solicitud.resultado;
+    }
+
+    // --- Lecturas habituales ---
+
+    bool existe(string_view ruta) const {
+        return leer([&](const ArbolJerarquia& a) { return a.obtenerNodo(ruta) != nullptr; });
+    }
+
+    /**
+     * @brief Recorre los hijos de una carpeta bajo candado compartido (equivalente a 'ls').
+     */
+    template <typename Visitante>
+    bool listarHijos(string_view ruta, Visitante visitante) const {
+        return leer([&](const ArbolJerarquia& a) { return a.visitarHijos(ruta, visitante); });
+    }
+
+    /**
+     * @brief Una página de hijos por nombre bajo candado compartido (ver ArbolJerarquia::paginaHijos).
+     * * 'despues' es un nombre; el cursor devuelto en 'siguiente' se traduce con nombreDeCursor.
+     */
+    template <typename Visitante>
+    bool listarPagina(string_view ruta, string_view despues, size_t limite, Visitante visitante, string& siguiente) const {
+        return leer([&](const ArbolJerarquia& a) {
+            vector<const Nodo*> pagina;
+            if (!a.paginaHijos(ruta, despues, limite, pagina, siguiente)) return false;
+            for (const Nodo* hijo : pagina) visitante(*hijo);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Autocompletado por prefijo sin copiar los nombres.
+     */
+    template <typename Visitante>
+    void buscarPorPrefijo(string_view prefijo, Visitante visitante) const {
+        leer([&](const ArbolJerarquia& a) { a.visitarPrefijo(prefijo, visitante); return true; });
+    }
+
+    /**
+     * @brief Búsqueda exacta; si hay coincidencia se entrega el nodo al visitante bajo el candado.
+     */
+    template <typename Visitante>
+    bool buscarExacto(string_view nombre, Visitante visitante) const {
+        return leer([&](const ArbolJerarquia& a) {
+            const Nodo* nodo = a.buscarExacto(nombre);
+            if (nodo) visitante(*nodo);
+            return nodo != nullptr;
+        });
+    }
+
+    // --- Escrituras habituales ---
+
+    bool crearNodo(const string& ruta_padre, const string& nombre, TipoNodo tipo, const string& contenido = "") {
+        return escribir([&](ArbolJerarquia& a) {
+            return a.crearNodo(ruta_padre, nombre, tipo, contenido);
+        });
+    }
+
+    bool renombrarNodo(const string& ruta, const string& nuevo_nombre) {
+        return escribir([&](ArbolJerarquia& a) { return a.renombrarNodo(ruta, nuevo_nombre); });
+    }
+
+    bool moverNodo(const string& ruta_origen, const string& ruta_destino) {
+        return escribir([&](ArbolJerarquia& a) { return a.moverNodo(ruta_origen, ruta_destino); });
+    }
+
+    bool eliminarNodo(const string& ruta) {
+        return escribir([&](ArbolJerarquia& a) { return a.eliminarNodo(ruta); });
+    }
+
+    bool guardar(const string& nombre_archivo = "jerarquia.json") {
+        // Candado exclusivo: un guardado a la vez (escribirJsonAtomico usa un temporal fijo por archivo)
+        unique_lock<shared_mutex> candado(mutex_arbol);
+        return arbol.guardar(nombre_archivo);
+    }
+
+    bool hashDe(string_view ruta, uint64_t& hash) const {
+        return leer([&](const ArbolJerarquia& a) { return a.hashDe(ruta, hash); });
+    }
+
+    bool cargar(const string& nombre_archivo = "jerarquia.json") {
+        return escribir([&](ArbolJerarquia& a) { return a.cargar(nombre_archivo); });
+    }
+
+    ReporteMemoria medirMemoria() const {
+        shared_lock<shared_mutex> candado(mutex_arbol);
+        return arbol.medirMemoria();
+    }
+
+    // Número medio de escrituras aplicadas por lote (1.0 = sin combinación)
+    double escriturasPorLote() {
+        lock_guard<mutex> candado_cola(mutex_cola);
+        return lotes_ejecutados ? double(escrituras_ejecutadas) / lotes_ejecutados : 0.0;
+    }
+};
+
+#endif // CONCURRENTE_HPP
@@ -0,0 +1,396 @@
+#ifndef DIFERENCIAS_HPP
+#define DIFERENCIAS_HPP
+
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+
+#include "arbol.hpp"
+
+// ==============================================
+// DIFERENCIAS ENTRE INSTANTÁNEAS
+// ==============================================
+//
+// Compara dos árboles guardados con 'save' y escribe los comandos (mkdir, touch, mv, rename, rm)
+// que convierten el primero en el segundo. Los nodos se alinean por su id persistente, así que un
+// nodo movido o renombrado sale como 'mv'/'rename' y no como un borrado más una creación.
+
+/**
+ * @brief Cifras de una comparación.
+ */
+struct ResultadoDiferencias {
+    size_t mkdir = 0, touch = 0, mv = 0, rename = 0, rm = 0;
+    size_t comparados = 0;        // Parejas de nodos examinadas (los subárboles idénticos cuentan 1)
+    size_t no_reproducibles = 0;  // Comandos con nombres o contenidos que el intérprete no lee tal cual
+    double segundos_carga = 0;    // Lectura y análisis de los dos JSON
+    double segundos = 0;          // Solo la comparación
+
+    size_t operaciones() const { return mkdir + touch + mv + rename + rm; }
+};
+
+/**
+ * @brief Calcula el guion que transforma el árbol 'a' en el 'b'.
+ * * Fase 1: se descienden los dos árboles a la vez desde la raíz. Una pareja con el mismo hash
+ *   Merkle es idéntica y no se abre; en las demás, los hijos se emparejan por id. Lo que queda
+ *   suelto a un lado se busca al otro: primero las raíces sueltas entre sí (un 'mv' simple) y, si
+ *   aún queda algo, se indexan los subárboles sueltos para encontrar nodos movidos dentro de ellos.
+ *   El coste es proporcional a los nodos de las carpetas cambiadas y de los subárboles añadidos o
+ *   borrados, no al tamaño del árbol.
+ * * Fase 2: se recorre en preorden la parte cambiada de 'b' colocando cada nodo bajo la pareja de
+ *   su padre (mv, rename, touch o mkdir). Cada comando se aplica también a 'a', así que la ruta
+ *   que se escribe es la que tendrá el nodo al reproducir el guion en ese punto. Si un nombre está
+ *   ocupado por un nodo que aún no ha llegado a su sitio, ese nodo se aparta con un nombre temporal.
+ * * Fase 3: se borra ('rm') lo que quedó sin pareja. Al final se comprueba que el hash de 'a'
+ *   coincide con el de 'b' (solo se recalculan los caminos tocados).
+ */
+class DiferenciadorArboles {
+private:
+    Nodo* raiz_a;                  // Se modifica: al terminar es una copia estructural de 'b'
+    const Nodo* raiz_b;
+    ostream& out;
+    ostream& errores;
+    ResultadoDiferencias& r;
+
+    unordered_map<const Nodo*, Nodo*> pareja;   // Nodo de b -> nodo de a (también los creados en a)
+    unordered_set<const Nodo*> distintos;       // Nodos de b cuya pareja tenía otro hash: hay que abrirlos
+    unordered_set<const Nodo*> emparejados_a;
+    vector<Nodo*> sueltos_a;                    // Nodos de a sin pareja cuyo padre sí la tiene
+    vector<const Nodo*> sueltos_b;              // Ídem en b
+    unordered_set<const Nodo*> colocados;       // Nodos de a ya en su sitio y con su nombre definitivo
+    vector<Nodo*> retirados;                    // Quitados de a durante la simulación (se liberan al final)
+
+    DiferenciadorArboles(Nodo* a, const Nodo* b, ostream& salida, ostream& err, ResultadoDiferencias& resultado)
+        : raiz_a(a), raiz_b(b), out(salida), errores(err), r(resultado) {}
+
+    // --- Fase 1: emparejar ---
+
+    void emparejar(Nodo* a, const Nodo* b, vector<Nodo*>& destino_a, vector<const Nodo*>& destino_b) {
+        vector<pair<Nodo*, const Nodo*>> pila{{a, b}};
+        unordered_map<string_view, Nodo*> por_id;
+        vector<const Nodo*> sin_pareja;
+        while (!pila.empty()) {
+            auto [na, nb] = pila.back();
+            pila.pop_back();
+            ++r.comparados;
+            pareja[nb] = na;
+            emparejados_a.insert(na);
+            if (na->obtenerHash() == nb->obtenerHash()) continue; // Subárboles idénticos
+            distintos.insert(nb);
+            if (na->tipo != TipoNodo::Carpeta) continue;
+
+            por_id.clear();
+            sin_pareja.clear();
+            for (Nodo* ha : na->hijos) por_id.emplace(ha->id(), ha);
+            for (const Nodo* hb : nb->hijos) {
+                auto it = por_id.find(hb->id());
+                if (it != por_id.end() && it->second->tipo == hb->tipo) {
+                    pila.emplace_back(it->second, hb);
+                    por_id.erase(it);
+                } else {
+                    sin_pareja.push_back(hb);
+                }
+            }
+            // Respaldo: un hijo borrado y vuelto a crear idéntico (otro id, mismo nombre y hash) no cambia nada
+            for (const Nodo* hb : sin_pareja) {
+                Nodo* ha = hijoConNombre(na, hb->nombre);
+                auto it = ha ? por_id.find(ha->id()) : por_id.end();
+                if (it != por_id.end() && it->second == ha && ha->obtenerHash() == hb->obtenerHash()) {
+                    pila.emplace_back(ha, hb);
+                    por_id.erase(it);
+                } else {
+                    destino_b.push_back(hb);
+                }
+            }
+            for (Nodo* ha : na->hijos) {
+                if (por_id.count(ha->id())) destino_a.push_back(ha); // Se recorre na->hijos para un orden estable
+            }
+        }
+    }
+
+    void alinear() {
+        emparejar(raiz_a, raiz_b, sueltos_a, sueltos_b);
+
+        // Raíces sueltas con el mismo id a ambos lados (movimientos simples); cada pareja nueva puede
+        // soltar más nodos, que se procesan en la misma pasada
+        unordered_map<string_view, Nodo*> raices_a;
+        vector<const Nodo*> por_indexar;
+        size_t ia = 0, ib = 0;
+        while (ia < sueltos_a.size() || ib < sueltos_b.size()) {
+            for (; ia < sueltos_a.size(); ++ia) raices_a.emplace(sueltos_a[ia]->id(), sueltos_a[ia]);
+            for (; ib < sueltos_b.size(); ++ib) {
+                const Nodo* hb = sueltos_b[ib];
+                auto it = raices_a.find(hb->id());
+                if (it != raices_a.end() && it->second->tipo == hb->tipo) {
+                    Nodo* ha = it->second;
+                    raices_a.erase(it);
+                    emparejar(ha, hb, sueltos_a, sueltos_b);
+                } else {
+                    por_indexar.push_back(hb);
+                }
+            }
+        }
+        if (por_indexar.empty() || raices_a.empty()) return;
+
+        // Nodos movidos dentro (o fuera) de subárboles añadidos o borrados: se indexan los subárboles
+        // sueltos de 'a' completos y se recorren los de 'b'
+        unordered_map<string_view, Nodo*> indice_a;
+        vector<Nodo*> pila_a;
+        for (const auto& [id, ha] : raices_a) pila_a.push_back(ha);
+        while (!pila_a.empty()) {
+            Nodo* ha = pila_a.back();
+            pila_a.pop_back();
+            ++r.comparados;
+            indice_a.emplace(ha->id(), ha);
+            pila_a.insert(pila_a.end(), ha->hijos.begin(), ha->hijos.end());
+        }
+        vector<const Nodo*> pila_b(por_indexar.rbegin(), por_indexar.rend());
+        while (!pila_b.empty()) {
+            const Nodo* hb = pila_b.back();
+            pila_b.pop_back();
+            ++r.comparados;
+            auto it = indice_a.find(hb->id());
+            if (it != indice_a.end() && it->second->tipo == hb->tipo && !emparejados_a.count(it->second)) {
+                // Sus hijos de 'a' sin pareja ya están indexados; los de 'b' siguen en esta pila
+                emparejar(it->second, hb, sueltos_a, pila_b);
+            } else {
+                for (auto h = hb->hijos.rbegin(); h != hb->hijos.rend(); ++h) pila_b.push_back(*h);
+            }
+        }
+    }
+
+    // --- Fase 2: colocar (escribe los comandos y los aplica a 'a') ---
+
+    static Nodo* hijoConNombre(const Nodo* padre, Nombre nombre) {
+        for (Nodo* hijo : padre->hijos) {
+            if (hijo->nombre == nombre) return hijo;
+        }
+        return nullptr;
+    }
+
+    static string ruta(const Nodo* nodo) {
+        if (!nodo->padre) return "/";
+        string resultado;
+        for (const Nodo* actual = nodo; actual->padre; actual = actual->padre) {
+            resultado.insert(0, actual->nombre.vista());
+            resultado.insert(0, 1, '/');
+        }
+        return resultado;
+    }
+
+    static string unir(const Nodo* padre, Nombre nombre) {
+        string base = ruta(padre);
+        if (base.size() > 1) base += '/';
+        return base + nombre;
+    }
+
+    // El guion no usa comillas: el intérprete separa las palabras por blancos, toma las que empiezan por
+    // comillas como citadas y lee el contenido de 'touch' como el resto de la línea sin los blancos de
+    // los extremos (ver LineaComando)
+    static bool reproducible(string_view texto, bool es_contenido) {
+        if (texto.empty()) return es_contenido;
+        if (texto.front() == '"' || texto.front() == '\'') return false;
+        if (!es_contenido) return texto.find_first_of(" \t\r\n") == string_view::npos;
+        auto blanco = [](char c) { return c == ' ' || c == '\t'; };
+        return !blanco(texto.front()) && !blanco(texto.back()) && texto.find_first_of("\r\n") == string_view::npos;
+    }
+
+    void comprobar(const Nodo* b) {
+        if (reproducible(b->nombre, false) && (b->tipo == TipoNodo::Carpeta || reproducible(b->contenido(), true))) return;
+        ++r.no_reproducibles;
+        errores << "Advertencia: '" << ruta(b) << "' tiene espacios, comillas o saltos de linea que el interprete no reproduce tal cual."
+                << endl;
+    }
+
+    static void desenganchar(Nodo* nodo) {
+        auto& hijos = nodo->padre->hijos;
+        hijos.erase(std::find(hijos.begin(), hijos.end(), nodo));
+        nodo->padre->invalidarHash();
+        nodo->padre = nullptr;
+    }
+
+    static void enganchar(Nodo* nodo, Nodo* padre) {
+        padre->hijos.push_back(nodo);
+        nodo->padre = padre;
+        padre->invalidarHash();
+    }
+
+    // true si ningún nodo del subárbol tiene pareja (se puede borrar ya entero)
+    bool todoSuelto(const Nodo* nodo) const {
+        vector<const Nodo*> pila{nodo};
+        while (!pila.empty()) {
+            const Nodo* actual = pila.back();
+            pila.pop_back();
+            if (emparejados_a.count(actual)) return false;
+            pila.insert(pila.end(), actual->hijos.begin(), actual->hijos.end());
+        }
+        return true;
+    }
+
+    void borrar(Nodo* nodo) {
+        out << "rm " << ruta(nodo) << '\n';
+        ++r.rm;
+        desenganchar(nodo);
+        retirados.push_back(nodo);
+    }
+
+    // Deja libre 'nombre' en 'padre' (salvo que lo tenga 'excepto'): el ocupante se borra si no tiene
+    // nada que conservar y, si no, se aparta con un nombre temporal hasta que le llegue su turno
+    void liberar(Nodo* padre, Nombre nombre, const Nodo* excepto) {
+        Nodo* ocupante = hijoConNombre(padre, nombre);
+        if (!ocupante || ocupante == excepto) return;
+        if (colocados.count(ocupante)) {
+            // 'b' tiene dos hermanos con el mismo nombre ('mv' no lo impide): las rutas del guion son ambiguas
+            ++r.no_reproducibles;
+            errores << "Advertencia: '" << unir(padre, nombre) << "' esta repetido en el segundo arbol." << endl;
+            return;
+        }
+        if (todoSuelto(ocupante)) {
+            borrar(ocupante);
+            return;
+        }
+        string temporal;
+        for (size_t k = 1;; ++k) {
+            temporal = nombre + ".~" + to_string(k);
+            if (TablaSimbolos::global().buscar(temporal) == SIN_SIMBOLO || !hijoConNombre(padre, Nombre(temporal))) break;
+        }
+        out << "rename " << ruta(ocupante) << ' ' << temporal << '\n';
+        ++r.rename;
+        ocupante->nombre = temporal;
+        ocupante->invalidarHash();
+    }
+
+    void colocar(Nodo* a, Nodo* padre, const Nodo* b) {
+        if (a->tipo == TipoNodo::Archivo && a->contenido() != b->contenido()) {
+            // No hay comando para editar un archivo: se borra y se crea ya en su sitio definitivo
+            borrar(a);
+            crear(b, padre);
+            return;
+        }
+        if (a->padre != padre) {
+            liberar(padre, a->nombre, a);
+            out << "mv " << ruta(a) << ' ' << ruta(padre) << '\n';
+            ++r.mv;
+            desenganchar(a);
+            enganchar(a, padre);
+        }
+        if (a->nombre != b->nombre) {
+            liberar(padre, b->nombre, a);
+            comprobar(b);
+            out << "rename " << ruta(a) << ' ' << b->nombre << '\n';
+            ++r.rename;
+            a->nombre = b->nombre;
+            a->invalidarHash();
+        }
+        colocados.insert(a);
+    }
+
+    void crear(const Nodo* b, Nodo* padre) {
+        liberar(padre, b->nombre, nullptr);
+        bool carpeta = b->tipo == TipoNodo::Carpeta;
+        comprobar(b);
+        out << (carpeta ? "mkdir " : "touch ") << ruta(padre) << ' ' << b->nombre;
+        if (!carpeta && !b->contenido().empty()) out << ' ' << b->contenido();
+        out << '\n';
+        ++(carpeta ? r.mkdir : r.touch);
+        Nodo* nuevo = new Nodo(b->nombre.str(), b->tipo, carpeta ? string() : b->contenido());
+        enganchar(nuevo, padre);
+        pareja[b] = nuevo;
+        colocados.insert(nuevo);
+    }
+
+    void escribirGuion() {
+        vector<const Nodo*> pila{raiz_b};
+        while (!pila.empty()) {
+            const Nodo* b = pila.back();
+            pila.pop_back();
+            Nodo* a = pareja.at(b);
+            for (auto h = b->hijos.rbegin(); h != b->hijos.rend(); ++h) {
+                const Nodo* hb = *h;
+                auto it = pareja.find(hb);
+                if (it == pareja.end()) {
+                    crear(hb, a);
+                    if (!hb->hijos.empty()) pila.push_back(hb);
+                } else {
+                    colocar(it->second, a, hb);
+                    if (distintos.count(hb)) pila.push_back(hb);
+                }
+            }
+        }
+        for (Nodo* suelto : sueltos_a) {
+            if (!emparejados_a.count(suelto) && suelto->padre) borrar(suelto);
+        }
+    }
+
+public:
+    /**
+     * @brief Escribe en 'out' el guion que convierte 'a' en 'b', un comando por línea.
+     * @param a Se modifica durante el cálculo (el llamador lo desecha después).
+     * @return false si la comprobación final falla (el guion no sería fiable).
+     */
+    static bool comparar(Nodo* a, const Nodo* b, ostream& out, ResultadoDiferencias& r, ostream& errores = cerr) {
+        auto inicio = chrono::steady_clock::now();
+        DiferenciadorArboles d(a, b, out, errores, r);
+        d.alinear();
+        d.escribirGuion();
+        out.flush();
+        for (Nodo* nodo : d.retirados) Reclamador::global().diferir(nodo);
+        r.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (a->obtenerHash() != b->obtenerHash()) {
+            errores << "Error: El guion generado no reproduce el segundo arbol." << endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Lee una instantánea JSON. Si todos sus nodos traen hash se usan tal cual (sin recalcular
+     *        el árbol entero); si no, se calculan. nullptr si no se pudo leer.
+     */
+    static Nodo* leerInstantanea(const string& archivo, ostream& errores = cerr) {
+        ifstream entrada(archivo);
+        if (!entrada.is_open()) {
+            errores << "Error: No se pudo abrir la instantanea '" << archivo << "'." << endl;
+            return nullptr;
+        }
+        try {
+            json j;
+            entrada >> j;
+            vector<pair<Nodo*, uint64_t>> hashes;
+            Nodo* raiz = Nodo::desdeJson(j, &hashes);
+            Consumo nodos, contenidos;
+            raiz->medirSubarbol(nodos, contenidos);
+            if (hashes.size() == nodos.objetos) {
+                for (const auto& [nodo, hash] : hashes) nodo->fijarHash(hash);
+            }
+            raiz->obtenerHash();
+            return raiz;
+        } catch (const exception& e) {
+            errores << "Error al cargar/parsear el JSON '" << archivo << "': " << e.what() << endl;
+            return nullptr;
+        }
+    }
+};
+
+/**
+ * @brief 'diff <snapA> <snapB>': escribe en 'out' el guion que convierte la primera instantánea en
+ *        la segunda (reproducible con 'load' de la primera seguido del guion).
+ */
+inline bool diferenciarInstantaneas(const string& archivo_a, const string& archivo_b, ostream& out,
+                                    ResultadoDiferencias& r, ostream& errores = cerr) {
+    auto inicio = chrono::steady_clock::now();
+    Nodo* a = DiferenciadorArboles::leerInstantanea(archivo_a, errores);
+    if (!a) return false;
+    Nodo* b = DiferenciadorArboles::leerInstantanea(archivo_b, errores);
+    if (!b) {
+        Reclamador::global().diferir(a);
+        return false;
+    }
+    r.segundos_carga = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    bool ok = DiferenciadorArboles::comparar(a, b, out, r, errores);
+    Reclamador::global().diferir(a);
+    Reclamador::global().diferir(b);
+    return ok;
+}
+
+#endif // DIFERENCIAS_HPP
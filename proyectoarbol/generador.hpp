@@ -0,0 +1,103 @@
+#ifndef GENERADOR_HPP
+#define GENERADOR_HPP
+
+#include <random>
+#include <deque>
+#include <unordered_set>
+
+#include "arbol.hpp"
+
+// ==============================================
+// GENERADOR DE ÁRBOLES SINTÉTICOS (benchmarks)
+// ==============================================
+
+/**
+ * @brief Parámetros del generador. Con la misma semilla se obtiene siempre el mismo árbol.
+ */
+struct ConfigGenerador {
+    uint32_t semilla = 42;
+    size_t nodos = 1000;             // Nodos a generar (sin contar la raíz)
+    int fanout_min = 2;              // Hijos por carpeta: uniforme en [fanout_min, fanout_max]
+    int fanout_max = 32;
+    int profundidad_max = 12;        // Las carpetas a esta profundidad solo reciben archivos
+    double prob_carpeta = 0.25;      // Probabilidad de que un hijo sea carpeta
+    int largo_min = 3;               // Longitud de nombre: uniforme en [largo_min, largo_max]
+    int largo_max = 16;
+    double prob_nombre_comun = 0.1;  // Probabilidad de usar un nombre frecuente ("README", "index.html"...)
+};
+
+/**
+ * @brief Genera entradas (ruta, tipo, contenido) en orden de anchura: cada padre precede a sus hijos,
+ *        de modo que pueden crearse una a una con crearNodo o todas con crearNodos.
+ */
+class GeneradorArbol {
+private:
+    ConfigGenerador config;
+    mt19937 gen;
+
+    static const vector<string>& nombresComunes() {
+        static const vector<string> comunes = {
+            "README", "index.html", "main.cpp", "LICENSE", "Makefile", "config.json",
+            "src", "include", "test", "docs", "build", ".gitignore", "package.json", "utils"
+        };
+        return comunes;
+    }
+
+    string nombreAleatorio(TipoNodo tipo) {
+        static const char alfabeto[] = "abcdefghijklmnopqrstuvwxyz0123456789_-";
+        uniform_int_distribution<int> largo(config.largo_min, config.largo_max);
+        uniform_int_distribution<int> letra(0, int(sizeof(alfabeto)) - 2);
+        string nombre(size_t(largo(gen)), ' ');
+        for (char& c : nombre) c = alfabeto[letra(gen)];
+        if (tipo == TipoNodo::Archivo) nombre += ".txt";
+        return nombre;
+    }
+
+public:
+    explicit GeneradorArbol(const ConfigGenerador& c) : config(c), gen(c.semilla) {}
+
+    vector<EntradaNodo> generar() {
+        struct Pendiente { string ruta; int profundidad; };
+        vector<EntradaNodo> entradas;
+        entradas.reserve(config.nodos);
+
+        uniform_int_distribution<int> fanout(config.fanout_min, max(config.fanout_min, config.fanout_max));
+        uniform_real_distribution<double> azar(0.0, 1.0);
+        uniform_int_distribution<size_t> comun(0, nombresComunes().size() - 1);
+        deque<Pendiente> cola{{"", 0}}; // "" = raíz
+        unordered_set<string> hermanos;
+        unordered_set<string> hermanos_raiz; // La raíz puede visitarse varias veces: se conservan sus nombres
+
+        while (entradas.size() < config.nodos) {
+            if (cola.empty()) cola.push_back({"", 0}); // Árbol agotado: la raíz recibe más hijos
+            Pendiente padre = std::move(cola.front());
+            cola.pop_front();
+
+            unordered_set<string>& usados = padre.ruta.empty() ? hermanos_raiz : hermanos;
+            if (!padre.ruta.empty()) hermanos.clear();
+            int hijos = fanout(gen);
+            for (int h = 0; h < hijos && entradas.size() < config.nodos; ++h) {
+                bool carpeta = padre.profundidad + 1 < config.profundidad_max && azar(gen) < config.prob_carpeta;
+                TipoNodo tipo = carpeta ? TipoNodo::Carpeta : TipoNodo::Archivo;
+
+                string nombre = azar(gen) < config.prob_nombre_comun ? nombresComunes()[comun(gen)] : nombreAleatorio(tipo);
+                while (!usados.insert(nombre).second) nombre = nombreAleatorio(tipo);
+
+                string ruta = padre.ruta + "/" + nombre;
+                entradas.push_back({ruta, tipo, carpeta ? "" : "contenido de " + nombre});
+                if (carpeta) cola.push_back({std::move(ruta), padre.profundidad + 1});
+            }
+        }
+        return entradas;
+    }
+
+    /**
+     * @brief Separa una ruta completa en (ruta del padre, nombre), como los espera crearNodo.
+     */
+    static pair<string, string> separar(const string& ruta) {
+        size_t barra = ruta.rfind('/');
+        return {barra == 0 ? "/" : ruta.substr(0, barra), ruta.substr(barra + 1)};
+    }
+};
+
+#endif // GENERADOR_HPP
@@ -0,0 +1,405 @@
+#ifndef GUARDADO_HPP
+#define GUARDADO_HPP
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
+
+#include "arbol.hpp"
+
+// ==============================================
+// GUARDADO EN SEGUNDO PLANO
+// ==============================================
+//
+// 'save --async' no deja el bucle de comandos parado mientras se construye el JSON y se escribe el
+// archivo: el hilo de comandos copia el árbol a una instantánea plana (O(n), sin JSON ni E/S) y un
+// hilo aparte la serializa y la publica con escribirJsonAtomico. Los contenidos no se copian: Nodo
+// nunca los modifica en sitio, así que la instantánea comparte el mismo string (copia al escribir).
+
+/**
+ * @brief Copia congelada del árbol en preorden con lo que escribe Nodo::aJson.
+ * * Se captura desde el hilo que modifica el árbol; después se puede serializar desde cualquier
+ *   otro (los nombres son símbolos y la tabla de símbolos se lee sin bloqueo).
+ */
+class InstantaneaGuardado {
+private:
+    struct Entrada {
+        Nombre nombre;
+        TipoNodo tipo;
+        bool ordenada;
+        uint32_t hijos; // Sus hijos son las entradas que le siguen (preorden)
+        uint64_t hash;
+        string id;
+        shared_ptr<const string> contenido;
+    };
+
+    vector<Entrada> entradas;
+
+public:
+    explicit InstantaneaGuardado(const Nodo* raiz) {
+        raiz->obtenerHash(); // Deja limpio todo el árbol: a partir de aquí cada obtenerHash() es O(1)
+        vector<const Nodo*> pila{raiz};
+        while (!pila.empty()) {
+            const Nodo* n = pila.back();
+            pila.pop_back();
+            entradas.push_back({n->nombre, n->tipo, n->orden() != nullptr, uint32_t(n->hijos.size()),
+                                n->obtenerHash(), n->id(), n->contenidoCompartido()});
+            for (auto it = n->hijos.rbegin(); it != n->hijos.rend(); ++it) pila.push_back(*it);
+        }
+    }
+
+    size_t size() const { return entradas.size(); }
+
+    /**
+     * @brief El mismo JSON que Nodo::aJson sobre la raíz capturada.
+     * * 'convertidos' avanza con los nodos ya convertidos (para informar del progreso).
+     */
+    json aJson(atomic<size_t>& convertidos) const {
+        json raiz;
+        vector<pair<json*, uint32_t>> abiertos; // (array "hijos" de una carpeta, hijos que le faltan)
+        size_t hechos = 0;
+        for (const Entrada& e : entradas) {
+            json* j = &raiz;
+            if (!abiertos.empty()) {
+                // Los hermanos anteriores ya están completos: que el array crezca no invalida nada vivo
+                json& hermanos = *abiertos.back().first;
+                hermanos.push_back(json::object());
+                j = &hermanos.back();
+                --abiertos.back().second;
+            }
+            (*j)["id"] = e.id;
+            (*j)["nombre"] = e.nombre.str();
+            (*j)["tipo"] = (e.tipo == TipoNodo::Carpeta ? "carpeta" : "archivo");
+            (*j)["contenido"] = e.contenido ? *e.contenido : string();
+            (*j)["hash"] = merkle::aTexto(e.hash);
+            if (e.ordenada) (*j)["ordenada"] = true;
+            json& hijos = (*j)["hijos"] = json::array();
+            if (e.hijos) {
+                hijos.get_ref<json::array_t&>().reserve(e.hijos);
+                abiertos.emplace_back(&hijos, e.hijos);
+            }
+            while (!abiertos.empty() && abiertos.back().second == 0) abiertos.pop_back();
+            if ((++hechos & 4095) == 0) convertidos.store(hechos, memory_order_relaxed);
+        }
+        convertidos.store(hechos, memory_order_relaxed);
+        return raiz;
+    }
+};
+
+/**
+ * @brief Un guardado en segundo plano a la vez: captura, lanza el hilo e informa del progreso.
+ * * Todos los métodos se llaman desde el hilo de comandos; el hilo de guardado solo escribe los
+ *   contadores atómicos y, antes de publicar el estado final, el error y la duración.
+ * * El destructor espera a que termine el guardado en curso.
+ */
+class GuardadoAsincrono {
+public:
+    enum class Estado : uint8_t { Inactivo, Serializando, Escribiendo, Terminado, Fallido };
+
+private:
+    thread hilo;
+    atomic<Estado> estado{Estado::Inactivo};
+    atomic<size_t> convertidos{0};
+    uint64_t ultimo_ticket = 0; // Numera los guardados lanzados (0 = ninguno)
+    size_t total = 0;
+    string ruta;
+    chrono::steady_clock::time_point inicio;
+    double segundos_captura = 0;
+    // Los escribe el hilo antes de publicar Terminado o Fallido
+    double segundos = 0;
+    double segundos_escritura = 0; // Solo la fase de E/S
+    size_t bytes = 0;
+    string error;
+
+public:
+    GuardadoAsincrono() = default;
+    GuardadoAsincrono(const GuardadoAsincrono&) = delete;
+    GuardadoAsincrono& operator=(const GuardadoAsincrono&) = delete;
+    ~GuardadoAsincrono() { esperar(); }
+
+    bool enCurso() const {
+        Estado e = estado.load(memory_order_acquire);
+        return e == Estado::Serializando || e == Estado::Escribiendo;
+    }
+
+    Estado estadoActual() const { return estado.load(memory_order_acquire); }
+
+    // Ticket del último guardado lanzado: el estado y los resultados de abajo son de ese guardado
+    uint64_t ticket() const { return ultimo_ticket; }
+
+    // Del último guardado: válidos cuando estadoActual() es Terminado
+    double segundosEscritura() const { return segundos_escritura; }
+    size_t bytesEscritos() const { return bytes; }
+    // Válido cuando estadoActual() es Fallido
+    const string& ultimoError() const { return error; }
+
+    // Bloquea hasta que acabe el guardado en curso (si lo hay)
+    void esperar() {
+        if (hilo.joinable()) hilo.join();
+    }
+
+    /**
+     * @brief Captura el árbol de 'raiz' y lo guarda en 'archivo' desde otro hilo.
+     * * La confirmación va a 'avisos' si no es nulo.
+     * * El resultado del guardado anterior se descarta: quien lo necesite debe leerlo antes.
+     * @return El ticket del guardado (ver ticket()), o 0 si ya había uno en curso.
+     */
+    uint64_t iniciar(const Nodo* raiz, const string& archivo, ostream* avisos, ostream& errores) {
+        if (enCurso()) {
+            errores << "Error: Ya hay un guardado en segundo plano hacia " << ruta << " (ver 'save status')." << endl;
+            return 0;
+        }
+        esperar();
+
+        inicio = chrono::steady_clock::now();
+        unique_ptr<InstantaneaGuardado> instantanea;
+        {
+            MedidaFase medida(Fase::GuardarCaptura);
+            instantanea = make_unique<InstantaneaGuardado>(raiz);
+        }
+        segundos_captura = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        total = instantanea->size();
+        ruta = archivo;
+        ++ultimo_ticket;
+        convertidos.store(0, memory_order_relaxed);
+        estado.store(Estado::Serializando, memory_order_release);
+
+        hilo = thread([this, instantanea = std::move(instantanea), archivo] {
+            Estado final = Estado::Terminado;
+            {
+                MedidaFase medida(Fase::Guardar);
+                try {
+                    json j = instantanea->aJson(convertidos);
+                    estado.store(Estado::Escribiendo, memory_order_release);
+                    auto inicio_escritura = chrono::steady_clock::now();
+                    bytes = escribirJsonAtomico(j, archivo);
+                    segundos_escritura = chrono::duration<double>(chrono::steady_clock::now() - inicio_escritura).count();
+                } catch (const exception& e) {
+                    error = e.what();
+                    final = Estado::Fallido;
+                }
+            }
+            segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+            estado.store(final, memory_order_release);
+        });
+
+        if (avisos) {
+            auto formato = avisos->flags();
+            auto precision = avisos->precision();
+            *avisos << "Guardando " << total << " nodos en " << archivo << " en segundo plano (instantanea en "
+                    << fixed << setprecision(1) << segundos_captura * 1e3 << " ms). Progreso: 'save status'." << endl;
+            avisos->flags(formato);
+            avisos->precision(precision);
+        }
+        return ultimo_ticket;
+    }
+
+    // 'save status'
+    void informar(ostream& out, ostream& err) const {
+        Estado e = estado.load(memory_order_acquire);
+        double transcurrido = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        auto formato = out.flags();
+        auto precision = out.precision();
+        out << fixed << setprecision(2);
+        switch (e) {
+        case Estado::Inactivo:
+            out << "No se ha lanzado ningun guardado en segundo plano." << endl;
+            break;
+        case Estado::Serializando: {
+            size_t hechos = convertidos.load(memory_order_relaxed);
+            out << "Guardando en " << ruta << ": serializando " << hechos << "/" << total << " nodos ("
+                << setprecision(1) << (total ? 100.0 * hechos / total : 100.0) << "%), " << setprecision(2)
+                << transcurrido << " s." << endl;
+            break;
+        }
+        case Estado::Escribiendo:
+            out << "Guardando en " << ruta << ": escribiendo el archivo (" << total << " nodos), " << transcurrido
+                << " s." << endl;
+            break;
+        case Estado::Terminado:
+            out << "Ultimo guardado en segundo plano: " << ruta << ", " << total << " nodos y " << bytes << " bytes en "
+                << segundos << " s (instantanea " << segundos_captura * 1e3 << " ms, escritura " << segundos_escritura
+                << " s)." << endl;
+            break;
+        case Estado::Fallido:
+            err << "Error: Fallo el guardado en segundo plano en " << ruta << ": " << error << endl;
+            break;
+        }
+        out.flags(formato);
+        out.precision(precision);
+    }
+};
+
+// ==============================================
+// AUTOGUARDADO
+// ==============================================
+
+/**
+ * @brief Umbrales del autoguardado. Un umbral a 0 no cuenta.
+ */
+struct ConfigAutoGuardado {
+    uint64_t operaciones = 1000;        // Cambios desde el último guardado
+    double segundos = 300;              // Tiempo desde el último guardado (si hay algún cambio)
+    uint64_t bytes = 1 << 20;           // Bytes de los comandos que cambiaron el árbol (contenidos incluidos)
+    double cuota = 0.10;                // Fracción máxima del tiempo que el disco dedica a los puntos de control
+    string archivo = "jerarquia.json";
+};
+
+/**
+ * @brief Lanza un 'save --async' (punto de control) cuando los cambios sin guardar cruzan un umbral.
+ * * Cuenta las operaciones que cambian el árbol y sus bytes desde el último guardado al archivo
+ *   configurado (manual o automático).
+ * * Limitación de E/S: si el último punto de control tardó T en escribirse, el siguiente no empieza
+ *   antes de T / cuota desde el inicio de aquel. Así los puntos de control ocupan como mucho esa
+ *   fracción del tiempo (y del ancho de banda) de disco aunque los umbrales se crucen sin parar.
+ * * Se evalúa desde el hilo de comandos (revisar) tras cada comando; el servidor además lo llama
+ *   periódicamente para que el umbral de tiempo salte sin comandos.
+ */
+class AutoGuardado {
+private:
+    using Reloj = chrono::steady_clock;
+
+    GuardadoAsincrono& guardado;
+    ConfigAutoGuardado config;
+    bool activo = false;
+    uint64_t operaciones = 0, bytes = 0; // Sin guardar
+    uint64_t operaciones_en_vuelo = 0, bytes_en_vuelo = 0; // En el punto de control en curso
+    uint64_t ticket_en_vuelo = 0; // Ticket del punto de control en curso (0 = ninguno)
+    Reloj::time_point ultimo_guardado = Reloj::now();
+    Reloj::time_point inicio_punto = Reloj::now();
+    Reloj::time_point permitido_desde = Reloj::now(); // Por la cuota de E/S
+    bool aplazado = false; // El umbral actual ya se contó como aplazado
+    size_t lanzados = 0, fallidos = 0, aplazados = 0;
+    uint64_t bytes_escritos = 0;
+    double segundos_escritura = 0;
+    Reloj::time_point activo_desde = Reloj::now();
+
+    // Umbral cruzado ("" si ninguno)
+    const char* umbralCruzado(Reloj::time_point ahora) const {
+        if (operaciones == 0) return "";
+        if (config.operaciones && operaciones >= config.operaciones) return "operaciones";
+        if (config.bytes && bytes >= config.bytes) return "bytes";
+        if (config.segundos > 0 && chrono::duration<double>(ahora - ultimo_guardado).count() >= config.segundos) return "tiempo";
+        return "";
+    }
+
+    // Recoge el resultado del punto de control propio que acaba de terminar
+    void recoger(Reloj::time_point ahora, ostream& err) {
+        // Si otro guardado ocupó ya el GuardadoAsincrono, el resultado propio se perdió: cuenta como fallido
+        bool propio = (guardado.ticket() == ticket_en_vuelo);
+        ticket_en_vuelo = 0;
+        if (propio && guardado.estadoActual() == GuardadoAsincrono::Estado::Terminado) {
+            bytes_escritos += guardado.bytesEscritos();
+            segundos_escritura += guardado.segundosEscritura();
+            auto espera = chrono::duration<double>(guardado.segundosEscritura() / config.cuota);
+            permitido_desde = inicio_punto + chrono::duration_cast<Reloj::duration>(espera);
+        } else {
+            // Los cambios siguen sin guardar; se reintenta pasado el umbral de tiempo (o un minuto)
+            operaciones += operaciones_en_vuelo;
+            bytes += bytes_en_vuelo;
+            ++fallidos;
+            permitido_desde = ahora + chrono::duration_cast<Reloj::duration>(
+                                          chrono::duration<double>(config.segundos > 0 ? config.segundos : 60.0));
+            err << "Advertencia: Fallo el autoguardado en " << config.archivo << ": "
+                << (propio ? guardado.ultimoError() : string("resultado no recogido")) << endl;
+        }
+        operaciones_en_vuelo = bytes_en_vuelo = 0;
+    }
+
+public:
+    explicit AutoGuardado(GuardadoAsincrono& g) : guardado(g) {}
+
+    bool estaActivo() const { return activo; }
+    const string& archivo() const { return config.archivo; }
+    ConfigAutoGuardado& configuracion() { return config; }
+
+    void activar(bool a) {
+        if (a && !activo) ultimo_guardado = activo_desde = Reloj::now(); // El tiempo cuenta desde que se activa
+        activo = a;
+    }
+
+    // Un comando cambió el árbol; 'bytes_cambio' es su tamaño (más el de los contenidos que añada)
+    void anotar(uint64_t bytes_cambio) {
+        ++operaciones;
+        bytes += bytes_cambio;
+    }
+
+    // Se ha guardado (o empezado a guardar) a mano el estado actual en 'destino'
+    void guardadoEn(const string& destino) {
+        if (destino != config.archivo) return;
+        operaciones = bytes = 0;
+        ultimo_guardado = Reloj::now();
+        aplazado = false;
+    }
+
+    /**
+     * @brief Recoge el punto de control propio si ya terminó. Llamar antes de lanzar otro guardado con
+     *        el mismo GuardadoAsincrono, que descartaría su resultado.
+     */
+    void recogerTerminado(ostream& err) {
+        if (ticket_en_vuelo && !guardado.enCurso()) recoger(Reloj::now(), err);
+    }
+
+    /**
+     * @brief Lanza el punto de control si toca. Llamar solo desde el hilo que modifica el árbol.
+     */
+    void revisar(const Nodo* raiz, ostream& err) {
+        if (!activo && !ticket_en_vuelo) return;
+        recogerTerminado(err);
+        auto ahora = Reloj::now();
+        if (!activo || guardado.enCurso() || !*umbralCruzado(ahora)) return;
+        if (ahora < permitido_desde) {
+            if (!aplazado) ++aplazados;
+            aplazado = true;
+            return;
+        }
+        ticket_en_vuelo = guardado.iniciar(raiz, config.archivo, nullptr, err);
+        if (!ticket_en_vuelo) return;
+        operaciones_en_vuelo = operaciones;
+        bytes_en_vuelo = bytes;
+        operaciones = bytes = 0;
+        ultimo_guardado = inicio_punto = ahora;
+        aplazado = false;
+        ++lanzados;
+    }
+
+    /**
+     * @brief Al salir: espera al punto de control en curso y dice si quedan cambios sin guardar
+     *        (con el autoguardado activo), para hacer un último guardado síncrono.
+     */
+    bool pendienteAlSalir(ostream& err) {
+        guardado.esperar();
+        recogerTerminado(err);
+        return activo && operaciones > 0;
+    }
+
+    // 'autosave'
+    void informar(ostream& out) const {
+        auto ahora = Reloj::now();
+        auto formato = out.flags();
+        auto precision = out.precision();
+        out << fixed << setprecision(1);
+        out << "Autoguardado " << (activo ? "activo" : "inactivo") << " en " << config.archivo << ": " << operaciones
+            << " operaciones y " << bytes << " bytes sin guardar desde hace "
+            << chrono::duration<double>(ahora - ultimo_guardado).count() << " s." << endl;
+        out << "  Umbrales: " << config.operaciones << " operaciones, " << config.segundos << " s, " << config.bytes
+            << " bytes (0 = sin umbral); cuota de E/S " << config.cuota * 100 << "%." << endl;
+        out << "  Puntos de control: " << lanzados << " lanzados, " << fallidos << " fallidos, " << aplazados
+            << " aplazados por la cuota";
+        if (ticket_en_vuelo) out << "; uno en curso";
+        if (permitido_desde > ahora) {
+            out << "; el siguiente dentro de " << setprecision(3) << chrono::duration<double>(permitido_desde - ahora).count()
+                << " s";
+        }
+        out << "." << endl;
+        double activo_s = chrono::duration<double>(ahora - activo_desde).count();
+        out << "  Escritos " << bytes_escritos << " bytes en " << setprecision(3) << segundos_escritura << " s de E/S ("
+            << setprecision(1) << (activo_s > 0 ? 100 * segundos_escritura / activo_s : 0.0) << "% del tiempo activo)."
+            << endl;
+        out.flags(formato);
+        out.precision(precision);
+    }
+};
+
+#endif // GUARDADO_HPP
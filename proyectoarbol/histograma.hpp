@@ -0,0 +1,93 @@
+#ifndef HISTOGRAMA_HPP
+#define HISTOGRAMA_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+// ==============================================
+// HISTOGRAMA DE LATENCIAS (estilo HDR)
+// ==============================================
+
+/**
+ * @brief Histograma de valores enteros (nanosegundos) con error relativo acotado, al estilo HDR.
+ * * Los valores menores que 64 tienen cubeta propia; a partir de ahí cada potencia de dos se divide
+ *   en 32 cubetas lineales, así que el error relativo de cualquier percentil es menor que 1/32 (~3%).
+ * * registrar() cuesta un clz, dos desplazamientos y un incremento: apto para caminos calientes.
+ * * El tamaño es fijo (1920 contadores) y dos histogramas se pueden combinar sumando cubetas.
+ */
+class HistogramaLatencia {
+public:
+    static constexpr int BITS_SUB = 5;
+    static constexpr uint64_t SUBCUBETAS = uint64_t(1) << BITS_SUB;        // 32
+    static constexpr size_t CUBETAS = 2 * SUBCUBETAS + (63 - BITS_SUB) * SUBCUBETAS;
+
+private:
+    std::array<uint64_t, CUBETAS> cubetas{};
+    uint64_t total = 0;
+    uint64_t suma = 0;
+    uint64_t maximo_ = 0;
+    uint64_t minimo_ = UINT64_MAX;
+
+public:
+    static size_t indice(uint64_t valor) {
+        if (valor < 2 * SUBCUBETAS) return size_t(valor);
+        int exponente = 63 - __builtin_clzll(valor) - BITS_SUB; // valor >> exponente queda en [32, 64)
+        return size_t(SUBCUBETAS * (exponente + 1) + ((valor >> exponente) - SUBCUBETAS));
+    }
+
+    // Menor valor que cae en la cubeta 'i'
+    static uint64_t limiteInferior(size_t i) {
+        if (i < 2 * SUBCUBETAS) return i;
+        int exponente = int(i / SUBCUBETAS) - 1;
+        return (SUBCUBETAS + i % SUBCUBETAS) << exponente;
+    }
+
+    // Mayor valor que cae en la cubeta 'i'
+    static uint64_t limiteSuperior(size_t i) {
+        return i + 1 < CUBETAS ? limiteInferior(i + 1) - 1 : UINT64_MAX;
+    }
+
+    void registrar(uint64_t valor) {
+        ++cubetas[indice(valor)];
+        ++total;
+        suma += valor;
+        maximo_ = std::max(maximo_, valor);
+        minimo_ = std::min(minimo_, valor);
+    }
+
+    void combinar(const HistogramaLatencia& otro) {
+        for (size_t i = 0; i < CUBETAS; ++i) cubetas[i] += otro.cubetas[i];
+        total += otro.total;
+        suma += otro.suma;
+        maximo_ = std::max(maximo_, otro.maximo_);
+        minimo_ = std::min(minimo_, otro.minimo_);
+    }
+
+    void reiniciar() { *this = HistogramaLatencia(); }
+
+    uint64_t cuenta() const { return total; }
+    uint64_t sumaTotal() const { return suma; }
+    uint64_t maximo() const { return total ? maximo_ : 0; }
+    uint64_t minimo() const { return total ? minimo_ : 0; }
+    double media() const { return total ? double(suma) / double(total) : 0.0; }
+    uint64_t enCubeta(size_t i) const { return cubetas[i]; }
+
+    /**
+     * @brief Valor del percentil q (0..1): el límite superior de la cubeta que lo contiene,
+     *        recortado al máximo observado.
+     */
+    uint64_t percentil(double q) const {
+        if (total == 0) return 0;
+        uint64_t objetivo = std::max<uint64_t>(1, uint64_t(q * double(total) + 0.5));
+        uint64_t acumulado = 0;
+        for (size_t i = 0; i < CUBETAS; ++i) {
+            acumulado += cubetas[i];
+            if (acumulado >= objetivo) return std::min(limiteSuperior(i), maximo_);
+        }
+        return maximo_;
+    }
+};
+
+#endif // HISTOGRAMA_HPP
@@ -0,0 +1,215 @@
+#ifndef IMPORTAR_HPP
+#define IMPORTAR_HPP
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "arbol.hpp"
+
+// ==============================================
+// IMPORTACIÓN DE DIRECTORIOS DEL SISTEMA (solo Linux)
+// ==============================================
+
+/**
+ * @brief Resultado de una importación: el subárbol construido (desvinculado) y sus cifras.
+ */
+struct ResultadoImportacion {
+    Nodo* raiz = nullptr;      // Propiedad de quien llama (normalmente se injerta en el árbol)
+    size_t carpetas = 0;
+    size_t archivos = 0;
+    size_t omitidos = 0;       // Enlaces simbólicos, dispositivos, sockets...
+    size_t errores = 0;        // Carpetas o archivos que no se pudieron leer
+    size_t bytes_contenido = 0;
+    double segundos = 0;       // Solo el recorrido (sin construir los índices)
+    string primer_error;
+
+    size_t entradas() const { return carpetas + archivos + omitidos; }
+};
+
+/**
+ * @brief Recorre un directorio real con varios hilos y construye el subárbol equivalente.
+ * * Cada hilo toma una carpeta pendiente, la abre con openat() relativo al directorio raíz y lee
+ *   sus entradas con getdents64 en su propio buffer de 64 KB. Solo ese hilo añade hijos a esa
+ *   carpeta, así que los nodos se construyen sin candados; el único punto compartido es la pila de
+ *   carpetas pendientes (LIFO: el recorrido se mantiene en profundidad y la pila, pequeña).
+ * * El tipo sale de d_type; si el sistema de archivos no lo da (DT_UNKNOWN) se pregunta con fstatat.
+ *   Los enlaces simbólicos no se siguen.
+ * * Los índices del árbol no se tocan: quien injerta el subárbol los construye de una vez.
+ */
+class ImportadorDirectorio {
+private:
+    static constexpr size_t TAM_BUFFER = 64 * 1024;
+
+    struct Tarea {
+        string ruta;   // Relativa al directorio raíz ("" = la raíz)
+        Nodo* carpeta;
+    };
+
+    // Cifras de un hilo; se suman al terminar
+    struct Cifras {
+        size_t carpetas = 0, archivos = 0, omitidos = 0, errores = 0, bytes = 0;
+    };
+
+    int fd_raiz;
+    bool con_contenido;
+    mutex m;
+    condition_variable cambio;
+    vector<Tarea> pendientes;
+    size_t en_curso = 0;
+    string primer_error;
+
+    ImportadorDirectorio(int fd, bool contenido) : fd_raiz(fd), con_contenido(contenido) {}
+
+    void anotarError(const string& ruta, int codigo, Cifras& cifras) {
+        ++cifras.errores;
+        lock_guard<mutex> candado(m);
+        if (primer_error.empty()) primer_error = (ruta.empty() ? string(".") : ruta) + ": " + strerror(codigo);
+    }
+
+    // Lee un archivo entero (relativo a la carpeta abierta 'fd_carpeta')
+    static bool leerArchivo(int fd_carpeta, const char* nombre, string& contenido) {
+        int fd = openat(fd_carpeta, nombre, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) contenido.reserve(size_t(st.st_size));
+        char bloque[TAM_BUFFER];
+        ssize_t n;
+        while ((n = read(fd, bloque, sizeof(bloque))) > 0) contenido.append(bloque, size_t(n));
+        close(fd);
+        return n == 0;
+    }
+
+    void escanear(const Tarea& tarea, vector<char>& buffer, vector<Tarea>& nuevas, Cifras& cifras) {
+        const char* ruta = tarea.ruta.empty() ? "." : tarea.ruta.c_str();
+        int fd = openat(fd_raiz, ruta, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0) {
+            anotarError(tarea.ruta, errno, cifras);
+            return;
+        }
+
+        long leidos;
+        while ((leidos = syscall(SYS_getdents64, fd, buffer.data(), buffer.size())) > 0) {
+            for (long desp = 0; desp < leidos;) {
+                // En Linux dirent64 tiene la misma disposición que la linux_dirent64 del núcleo
+                const dirent64* d = reinterpret_cast<const dirent64*>(buffer.data() + desp);
+                desp += d->d_reclen;
+                const char* nombre = d->d_name;
+                if (nombre[0] == '.' && (nombre[1] == '\0' || (nombre[1] == '.' && nombre[2] == '\0'))) continue;
+
+                unsigned char tipo = d->d_type;
+                if (tipo == DT_UNKNOWN) {
+                    struct stat st;
+                    if (fstatat(fd, nombre, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                        anotarError(tarea.ruta + "/" + nombre, errno, cifras);
+                        continue;
+                    }
+                    tipo = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_LNK;
+                }
+
+                if (tipo == DT_DIR) {
+                    Nodo* hijo = new Nodo(nombre, TipoNodo::Carpeta);
+                    hijo->padre = tarea.carpeta;
+                    tarea.carpeta->hijos.push_back(hijo);
+                    ++cifras.carpetas;
+                    nuevas.push_back({tarea.ruta.empty() ? string(nombre) : tarea.ruta + "/" + nombre, hijo});
+                } else if (tipo == DT_REG) {
+                    string contenido;
+                    if (con_contenido && !leerArchivo(fd, nombre, contenido)) {
+                        anotarError(tarea.ruta + "/" + nombre, errno, cifras);
+                    }
+                    cifras.bytes += contenido.size();
+                    Nodo* hijo = new Nodo(nombre, TipoNodo::Archivo, std::move(contenido));
+                    hijo->padre = tarea.carpeta;
+                    tarea.carpeta->hijos.push_back(hijo);
+                    ++cifras.archivos;
+                } else {
+                    ++cifras.omitidos;
+                }
+            }
+        }
+        if (leidos < 0) anotarError(tarea.ruta, errno, cifras);
+        close(fd);
+    }
+
+    void trabajador(Cifras& cifras) {
+        vector<char> buffer(TAM_BUFFER);
+        vector<Tarea> nuevas;
+        unique_lock<mutex> candado(m);
+        while (true) {
+            cambio.wait(candado, [&] { return !pendientes.empty() || en_curso == 0; });
+            if (pendientes.empty()) break; // Nadie trabaja y no queda nada: fin
+            Tarea tarea = std::move(pendientes.back());
+            pendientes.pop_back();
+            ++en_curso;
+            candado.unlock();
+
+            escanear(tarea, buffer, nuevas, cifras);
+
+            candado.lock();
+            --en_curso;
+            for (Tarea& t : nuevas) pendientes.push_back(std::move(t));
+            nuevas.clear();
+            if (!pendientes.empty() || en_curso == 0) cambio.notify_all();
+        }
+    }
+
+public:
+    // Nombre de la carpeta que creará la importación: el último componente del directorio
+    static string nombreRaiz(const string& directorio) {
+        string nombre = directorio;
+        while (nombre.size() > 1 && nombre.back() == '/') nombre.pop_back();
+        nombre = nombre.substr(nombre.find_last_of('/') + 1);
+        if (nombre.empty() || nombre == "." || nombre == "..") nombre = "importado";
+        return nombre;
+    }
+
+    /**
+     * @brief Importa 'directorio' como una carpeta nueva (con su mismo nombre) y todo su contenido.
+     * @param con_contenido Si es true, el texto de cada archivo se copia en Nodo::contenido.
+     * @param hilos 0 = uno por núcleo.
+     * @return false si el directorio no se pudo abrir (los fallos parciales se cuentan en 'errores').
+     */
+    static bool importar(const string& directorio, bool con_contenido, size_t hilos, ResultadoImportacion& r,
+                         ostream& errores = cerr) {
+        auto inicio = chrono::steady_clock::now();
+        int fd = open(directorio.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            errores << "Error: No se pudo abrir el directorio '" << directorio << "': " << strerror(errno) << endl;
+            return false;
+        }
+
+        ImportadorDirectorio importador(fd, con_contenido);
+        r.raiz = new Nodo(nombreRaiz(directorio), TipoNodo::Carpeta);
+        importador.pendientes.push_back({"", r.raiz});
+
+        if (hilos == 0) hilos = max(1u, thread::hardware_concurrency());
+        vector<Cifras> cifras(hilos);
+        vector<thread> grupo;
+        for (size_t i = 1; i < hilos; ++i) grupo.emplace_back(&ImportadorDirectorio::trabajador, &importador, ref(cifras[i]));
+        importador.trabajador(cifras[0]); // El hilo que llama también trabaja
+        for (thread& t : grupo) t.join();
+        close(fd);
+
+        for (const Cifras& c : cifras) {
+            r.carpetas += c.carpetas;
+            r.archivos += c.archivos;
+            r.omitidos += c.omitidos;
+            r.errores += c.errores;
+            r.bytes_contenido += c.bytes;
+        }
+        r.primer_error = std::move(importador.primer_error);
+        r.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        return true;
+    }
+};
+
+#endif // IMPORTAR_HPP
@@ -0,0 +1,513 @@
+#ifndef INTERPRETE_HPP
+#define INTERPRETE_HPP
+
+#include "arbol.hpp"
+#include "comandos.hpp"
+#include "traza.hpp"
+#include "tar.hpp"
+#include "diferencias.hpp"
+#include "guardado.hpp"
+#ifdef __linux__
+#include "importar.hpp" // 'import' de directorios reales: openat/getdents64 (solo Linux)
+#endif
+
+// ==============================================
+// INTERPRETE DE COMANDOS
+// ==============================================
+
+/**
+ * @brief Ejecuta las líneas de comando de la consola sobre un árbol (que es dueño de su papelera).
+ * * Toda la salida (incluidos los mensajes del propio árbol) va a los flujos indicados en cada
+ *   llamada, de modo que la misma lógica sirve a la consola interactiva y al servidor.
+ * * Las líneas se leen con LineaComando y comandos::buscar (ver comandos.hpp): los argumentos son
+ *   vistas de la línea y ni la lectura ni la elección del comando reservan memoria.
+ */
+class Interprete {
+private:
+    ArbolJerarquia& arbol;
+    bool silencioso = false; // Modo por lotes: sin confirmaciones, solo resultados y errores
+    GrabadorTraza* grabador = nullptr; // Si no es nulo, cada línea recibida se graba en la traza
+    GuardadoAsincrono guardado;        // 'save --async' (se espera a que acabe al destruir el intérprete)
+    AutoGuardado autoguardado{guardado};
+
+public:
+    explicit Interprete(ArbolJerarquia& a) : arbol(a) {}
+
+    static void mostrarMenu(ostream& out) {
+        out << "\n" << string(50, '=') << endl;
+        out << "  MINI-SUITE DE GESTION DE ARCHIVOS (ARBOLES)" << endl;
+        out << string(50, '=') << endl;
+        out << "Comandos:" << endl;
+        out << "  - mkdir <ruta_padre> <nombre_carpeta>    (Crear Carpeta)" << endl;
+        out << "  - mkdir -p <ruta>                        (Crear Carpetas Intermedias)" << endl;
+        out << "  - touch <ruta_padre> <nombre_archivo> [contenido] (Crear Archivo; el resto de la linea)" << endl;
+        out << "  - mv <ruta_origen> <ruta_destino>        (Mover Nodo)" << endl;
+        out << "  - rm <ruta>                              (Eliminar a Papelera)" << endl;
+        out << "  - papelera [limite <bytes>]              (Ver Papelera / Fijar su Limite)" << endl;
+        out << "  - restore <id>                           (Restaurar desde la Papelera)" << endl;
+        out << "  - clear_trash                            (Vaciar Papelera)" << endl;
+        out << "  - undo / redo                            (Deshacer / Rehacer)" << endl;
+        out << "  - historial [limite <n>]                 (Ver Historial / Fijar su Profundidad)" << endl;
+        out << "  - ls <ruta> [--sorted]                   (Listar Hijos / por Nombre)" << endl;
+        out << "  - ls <ruta> --limit N [--after X]        (Pagina por Nombre; X = nombre o cursor)" << endl;
+        out << "  - sort <ruta> on|off                     (Indice Ordenado de los Hijos)" << endl;
+        out << "  - rename <ruta> <nuevo_nombre>           (Renombrar Nodo)" << endl;
+        out << "  - search <prefijo_o_nombre>              (Busqueda/Autocompletado: Trie y Hash)" << endl;
+        out << "  - hash <ruta>                            (Hash Merkle del Subarbol)" << endl;
+        out << "  - export preorden                        (Exportar Recorrido)" << endl;
+        out << "  - export tar <ruta> <archivo.tar>        (Exportar Subarbol a tar)" << endl;
+        out << "  - import <dir> <ruta> [--with-content] [--hilos N] (Importar Directorio Real)" << endl;
+        out << "  - import tar <archivo.tar> <ruta>        (Importar tar)" << endl;
+        out << "  - save / load [archivo]                  (Persistencia JSON)" << endl;
+        out << "  - save --async [archivo] / save status   (Guardar en Segundo Plano / Progreso)" << endl;
+        out << "  - autosave [on [archivo] | off]          (Autoguardado: Estado / Activar)" << endl;
+        out << "  - autosave ops|segundos|bytes N | cuota P (Umbrales, 0 = sin umbral; % de E/S)" << endl;
+        out << "  - diff <snapA> <snapB>                   (Guion que lleva de snapA a snapB)" << endl;
+        out << "  - stats [reset]                          (Metricas de Latencia)" << endl;
+        out << "  - mem [json]                             (Memoria por Subsistema)" << endl;
+        out << "  - help / exit" << endl;
+        out << "Los argumentos con espacios van entre comillas: mkdir / \"mi carpeta\"" << endl;
+        out << string(50, '=') << endl;
+    }
+
+    /**
+     * @brief En modo silencioso ni el intérprete ni el árbol imprimen confirmaciones por comando.
+     */
+    void modoSilencioso(bool activo) {
+        silencioso = activo;
+        arbol.modoSilencioso(activo);
+    }
+
+    /**
+     * @brief Graba en 'g' (o deja de grabar, con nullptr) todas las líneas que se ejecuten.
+     */
+    void grabarEn(GrabadorTraza* g) { grabador = g; }
+
+    AutoGuardado& autoguardadoActual() { return autoguardado; }
+
+    /**
+     * @brief Lanza el punto de control del autoguardado si toca (ver AutoGuardado::revisar). Lo
+     *        llama ejecutar tras cada comando; el servidor, también cuando no llegan comandos.
+     */
+    void revisarAutoguardado(ostream& err) { autoguardado.revisar(arbol.obtenerNodo("/"), err); }
+
+    /**
+     * @brief Al salir: espera al 'save --async' en curso (si lo hay) y, con el autoguardado activo y
+     *        cambios sin guardar, hace un último guardado. Para salir sin destruir el intérprete (ver
+     *        la salida rápida de main) sin perder nada a medio escribir.
+     */
+    void terminar(ostream& err) {
+        if (!autoguardado.pendienteAlSalir(err)) return;
+        if (arbol.guardar(autoguardado.archivo())) autoguardado.guardadoEn(autoguardado.archivo());
+    }
+
+    /**
+     * @brief Ejecuta una línea de comando.
+     * @return false si el comando fue 'exit'.
+     */
+    bool ejecutar(string_view linea, ostream& out, ostream& err) {
+        if (grabador) grabador->registrar(linea);
+        uint64_t inicio = Metricas::ahora();
+        LineaComando palabras(linea);
+        comandos::Comando comando = comandos::buscar(palabras[0]);
+        arbol.redirigirSalida(out, err);
+        bool seguir = ejecutarComando(comando, palabras, out, err);
+        Metricas::global().comando(size_t(comando)).registrar(Metricas::ahora() - inicio);
+        revisarAutoguardado(err);
+        arbol.redirigirSalida(cout, cerr); // Los flujos de la llamada pueden dejar de existir
+        return seguir;
+    }
+
+private:
+    // ls [ruta] [--sorted] [--limit N] [--after <nombre|cursor>]
+    void listar(const LineaComando& l, ostream& err) {
+        string_view ruta, despues;
+        bool ordenado = false, paginado = false, valido = true;
+        uint64_t limite = SIZE_MAX;
+        for (size_t i = 1; valido && i < l.size(); ++i) {
+            string_view opcion = l[i];
+            if (opcion == "--sorted") {
+                ordenado = true;
+            } else if (opcion == "--limit" && comandos::numero(l[i + 1], limite) && limite > 0) {
+                paginado = true;
+                ++i;
+            } else if (opcion == "--after" && i + 1 < l.size()) {
+                despues = l[++i];
+                paginado = true;
+            } else if (opcion.substr(0, 2) != "--" && ruta.empty()) {
+                ruta = opcion;
+            } else {
+                valido = false;
+            }
+        }
+        if (!valido) {
+            err << "Uso: ls <ruta> [--sorted] [--limit N] [--after <nombre|cursor>]" << endl;
+            return;
+        }
+        if (ruta.empty()) ruta = "/";
+        if (paginado) arbol.listarPagina(ruta, limite, despues); // Siempre por nombre
+        else arbol.listarHijos(ruta, ordenado);
+    }
+
+    // import <directorio_host> <ruta> [--with-content] [--hilos N]. true si el árbol cambió; en
+    // 'bytes', los de contenido importados
+    bool importar(const LineaComando& l, ostream& out, ostream& err, uint64_t& bytes) {
+        if (l[1] == "tar") { // Para un directorio llamado así: import ./tar ...
+            if (!l[2].empty() && !l[3].empty()) {
+                return importarTar(string(l[2]), string(l[3]), out, err, bytes);
+            }
+            err << "Uso: import tar <archivo.tar> <ruta>" << endl;
+            return false;
+        }
+        string origen(l[1]), destino(l[2]);
+        bool con_contenido = false;
+        uint64_t hilos = 0;
+        bool valido = !origen.empty() && !destino.empty();
+        for (size_t i = 3; valido && i < l.size(); ++i) {
+            if (l[i] == "--with-content") con_contenido = true;
+            else if (l[i] == "--hilos" && comandos::numero(l[i + 1], hilos)) ++i;
+            else valido = false;
+        }
+        if (!valido) {
+            err << "Uso: import <dir> <ruta> [--with-content] [--hilos N]" << endl;
+            return false;
+        }
+#ifdef __linux__
+        // Comprobar el destino antes de recorrer nada
+        string nombre = ImportadorDirectorio::nombreRaiz(origen);
+        Nodo* padre = arbol.obtenerNodo(destino);
+        if (!padre || padre->tipo != TipoNodo::Carpeta) {
+            err << "Error: Ruta padre '" << destino << "' no encontrada o no es una carpeta." << endl;
+            return false;
+        }
+        if (arbol.obtenerNodo(destino + "/" + nombre)) {
+            err << "Error: Ya existe un nodo con el nombre '" << nombre << "' en esta ruta." << endl;
+            return false;
+        }
+        auto inicio = chrono::steady_clock::now();
+        ResultadoImportacion r;
+        if (!ImportadorDirectorio::importar(origen, con_contenido, hilos, r, err)) return false;
+        if (r.errores) err << "Advertencia: " << r.errores << " entradas no se pudieron leer (" << r.primer_error << ")." << endl;
+        if (!arbol.injertarSubarbol(destino, r.raiz)) return false;
+        bytes = r.bytes_contenido;
+        double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (!silencioso) {
+            ios::fmtflags formato = out.flags();
+            streamsize precision = out.precision();
+            out << "Importado '" << nombre << "' en " << destino << ": " << r.carpetas << " carpetas, " << r.archivos
+                << " archivos";
+            if (con_contenido) out << " (" << r.bytes_contenido << " bytes)";
+            if (r.omitidos) out << ", " << r.omitidos << " omitidos";
+            out << " en " << fixed << setprecision(3) << segundos << " s, recorrido " << r.segundos << " s ("
+                << setprecision(0) << (segundos > 0 ? r.entradas() / segundos : 0.0) << " entradas/s)." << endl;
+            out.flags(formato);
+            out.precision(precision);
+        }
+        return true;
+#else
+        (void)out;
+        (void)bytes;
+        err << "Error: 'import' solo esta disponible en Linux." << endl;
+        return false;
+#endif
+    }
+
+    // diff <snapA> <snapB>: el guion va a 'out' sin adornos (en modo silencioso se puede reproducir tal cual)
+    void diferenciar(const string& archivo_a, const string& archivo_b, ostream& out, ostream& err) {
+        ResultadoDiferencias r;
+        if (!diferenciarInstantaneas(archivo_a, archivo_b, out, r, err) || silencioso) return;
+        ios::fmtflags formato = out.flags();
+        streamsize precision = out.precision();
+        out << r.operaciones() << " operaciones (" << r.mkdir << " mkdir, " << r.touch << " touch, " << r.mv << " mv, "
+            << r.rename << " rename, " << r.rm << " rm); " << r.comparados << " nodos comparados en " << fixed
+            << setprecision(3) << r.segundos * 1000 << " ms (carga " << r.segundos_carga << " s)." << endl;
+        if (r.no_reproducibles) out << r.no_reproducibles << " comando(s) con espacios o comillas que no se reproducen tal cual." << endl;
+        out.flags(formato);
+        out.precision(precision);
+    }
+
+    // export tar <ruta> <archivo>
+    void exportarTar(const string& ruta, const string& archivo, ostream& out, ostream& err) {
+        const Nodo* nodo = arbol.obtenerNodo(ruta);
+        if (!nodo) {
+            err << "Error: Ruta '" << ruta << "' no encontrada." << endl;
+            return;
+        }
+        ResultadoTar r;
+        if (!::exportarTar(nodo, archivo, r, err) || silencioso) return;
+        informarTar("Exportado", ruta, archivo, r, out);
+    }
+
+    // import tar <archivo> <ruta>: se lee en una carpeta aparte y se injertan sus entradas de primer nivel
+    // (todas o ninguna; un 'undo' las quita todas)
+    bool importarTar(const string& archivo, const string& destino, ostream& out, ostream& err, uint64_t& bytes) {
+        Nodo* padre = arbol.obtenerNodo(destino);
+        if (!padre || padre->tipo != TipoNodo::Carpeta) {
+            err << "Error: Ruta padre '" << destino << "' no encontrada o no es una carpeta." << endl;
+            return false;
+        }
+        ResultadoTar r;
+        Nodo* temporal = new Nodo("/", TipoNodo::Carpeta);
+        bool leido = false;
+        try {
+            leido = ::importarTar(archivo, temporal, r, err);
+        } catch (const exception& e) { // Sin memoria para una entrada, por ejemplo: lo leído se descarta
+            err << "Error: Fallo al leer '" << archivo << "': " << e.what() << endl;
+        }
+        vector<Nodo*> primer_nivel = temporal->hijos.soltar();
+        delete temporal;
+        for (Nodo* nodo : primer_nivel) nodo->padre = nullptr;
+        // Todo o nada: si una entrada de primer nivel choca con un nombre del destino, no se importa nada
+        if (leido) {
+            leido = arbol.injertarSubarboles(destino, primer_nivel);
+        } else {
+            for (Nodo* nodo : primer_nivel) Reclamador::global().diferir(nodo);
+        }
+        if (leido && !silencioso) informarTar("Importado", archivo, destino, r, out);
+        bytes = r.bytes_contenido;
+        return leido;
+    }
+
+    static void informarTar(const char* accion, const string& origen, const string& destino, const ResultadoTar& r,
+                            ostream& out) {
+        ios::fmtflags formato = out.flags();
+        streamsize precision = out.precision();
+        double mib = r.bytes_archivo / 1048576.0;
+        out << accion << " '" << origen << "' -> '" << destino << "': " << r.carpetas << " carpetas, " << r.archivos
+            << " archivos";
+        if (r.omitidos) out << ", " << r.omitidos << " omitidos";
+        out << ", " << fixed << setprecision(1) << mib << " MiB en " << setprecision(3) << r.segundos << " s ("
+            << setprecision(1) << (r.segundos > 0 ? mib / r.segundos : 0.0) << " MiB/s)." << endl;
+        out.flags(formato);
+        out.precision(precision);
+    }
+
+    // autosave [on [archivo] | off] | autosave ops|segundos|bytes <n> | autosave cuota <porcentaje>
+    void configurarAutoguardado(const LineaComando& l, ostream& out, ostream& err) {
+        string_view opcion = l[1], arg = l[2];
+        ConfigAutoGuardado& config = autoguardado.configuracion();
+        uint64_t valor = 0;
+        bool numerico = l.size() == 3 && comandos::numero(arg, valor);
+        if (opcion.empty()) {
+            autoguardado.informar(out);
+            return;
+        }
+        if (opcion == "on" && l.size() <= 3) {
+            if (!arg.empty()) config.archivo = string(arg);
+            autoguardado.activar(true);
+        } else if (opcion == "off" && l.size() == 2) {
+            autoguardado.activar(false);
+        } else if (opcion == "ops" && numerico) {
+            config.operaciones = valor;
+        } else if (opcion == "segundos" && numerico) {
+            config.segundos = double(valor);
+        } else if (opcion == "bytes" && numerico) {
+            config.bytes = valor;
+        } else if (opcion == "cuota" && numerico && valor >= 1 && valor <= 100) {
+            config.cuota = valor / 100.0;
+        } else {
+            err << "Uso: autosave [on [archivo] | off] | autosave ops|segundos|bytes <n> | autosave cuota <1-100>" << endl;
+            return;
+        }
+        if (!silencioso) autoguardado.informar(out);
+    }
+
+    // search <nombre>: coincidencia exacta (Hash Map) y autocompletado por prefijo (Trie)
+    void buscar(string_view nombre, ostream& out) {
+        Nodo* encontrado = arbol.buscarExacto(nombre);
+        bool encontrado_hash = (encontrado != nullptr);
+
+        if (encontrado_hash) {
+            out << "\n[OK] Coincidencia exacta (Hash Map) con nombre '" << nombre << "':" << endl;
+            out << "  - Tipo: " << (encontrado->tipo == TipoNodo::Carpeta ? "Carpeta" : "Archivo") << endl;
+            out << "  - Ruta: " << arbol.mostrarRuta(encontrado) << endl;
+        }
+
+        vector<string> resultados = arbol.buscarPorPrefijo(string(nombre));
+        if (!resultados.empty()) {
+            out << "\n[STAR] Autocompletado por prefijo ('" << nombre << "'):" << endl;
+            for (const string& resultado : resultados) {
+                out << "  - " << resultado << endl;
+            }
+        } else if (!encontrado_hash) {
+            out << "\n[FAIL] No se encontraron coincidencias." << endl;
+        }
+    }
+
+    bool ejecutarComando(comandos::Comando comando, const LineaComando& l, ostream& out, ostream& err) {
+        using comandos::Comando;
+        if (!l.valida()) {
+            err << "Error: Comillas sin cerrar." << endl;
+            return true;
+        }
+        string_view arg1 = l[1], arg2 = l[2], arg3 = l[3];
+        uint64_t valor;
+        bool cambio = false;         // El comando modificó el árbol (para el autoguardado)
+        uint64_t bytes_contenido = 0; // Contenidos importados, que no están en la línea
+
+        switch (comando) {
+        case Comando::Exit:
+            if (!silencioso && autoguardado.estaActivo()) {
+                out << "Saliendo. El autoguardado guarda los cambios pendientes en " << autoguardado.archivo() << "." << endl;
+            } else if (!silencioso) {
+                out << "Saliendo. No olvides hacer 'save'!" << endl;
+            }
+            return false;
+        case Comando::Help:
+            mostrarMenu(out);
+            break;
+        case Comando::Save:
+            if (arg1 == "status" || l.size() > (arg1 == "--async" ? 3 : 2)) {
+                if (arg1 == "status" && l.size() == 2) guardado.informar(out, err);
+                else err << "Uso: save [archivo] | save --async [archivo] | save status" << endl;
+            } else if (arg1 == "--async") {
+                string archivo = arg2.empty() ? "jerarquia.json" : string(arg2);
+                autoguardado.recogerTerminado(err); // Antes de que este guardado descarte su resultado
+                if (guardado.iniciar(arbol.obtenerNodo("/"), archivo, silencioso ? nullptr : &out, err)) {
+                    autoguardado.guardadoEn(archivo);
+                }
+            } else {
+                string archivo = arg1.empty() ? "jerarquia.json" : string(arg1);
+                guardado.esperar(); // Que un guardado en segundo plano anterior no pise a este al publicarse
+                autoguardado.recogerTerminado(err);
+                if (arbol.guardar(archivo)) autoguardado.guardadoEn(archivo);
+            }
+            break;
+        case Comando::Load: {
+            // Si no carga, el árbol no cambia; si carga, solo coincide con lo guardado si viene del propio archivo
+            string archivo = arg1.empty() ? "jerarquia.json" : string(arg1);
+            if (!arbol.cargar(archivo)) break;
+            if (archivo == autoguardado.archivo()) autoguardado.guardadoEn(archivo);
+            else cambio = true;
+            break;
+        }
+        case Comando::Autosave:
+            configurarAutoguardado(l, out, err);
+            break;
+        case Comando::Diff:
+            if (!arg1.empty() && !arg2.empty()) {
+                diferenciar(string(arg1), string(arg2), out, err);
+            } else { err << "Uso: diff <snapA> <snapB>" << endl; }
+            break;
+        case Comando::Stats:
+            if (arg1 == "reset") {
+                Metricas::global().reiniciar();
+                if (!silencioso) out << "Metricas reiniciadas." << endl;
+            } else if (arg1.empty()) {
+                Metricas::global().imprimir(out);
+            } else { err << "Uso: stats [reset]" << endl; }
+            break;
+        case Comando::Mem:
+            if (arg1 == "json") {
+                out << arbol.medirMemoria().aJson() << endl;
+            } else if (arg1.empty()) {
+                arbol.medirMemoria().imprimir(out);
+            } else { err << "Uso: mem [json]" << endl; }
+            break;
+        case Comando::Mkdir:
+            if (arg1 == "-p" && !arg2.empty()) {
+                cambio = arbol.crearRuta(arg2);
+            } else if (arg1 != "-p" && !arg1.empty() && !arg2.empty()) {
+                cambio = arbol.crearNodo(arg1, arg2, TipoNodo::Carpeta);
+            } else { err << "Uso: mkdir <ruta_padre> <nombre_carpeta> | mkdir -p <ruta>" << endl; }
+            break;
+        case Comando::Touch:
+            // El contenido es el resto de la línea tal cual, con sus espacios
+            if (!arg1.empty() && !arg2.empty()) {
+                cambio = arbol.crearNodo(arg1, arg2, TipoNodo::Archivo, l.resto(3));
+            } else { err << "Uso: touch <ruta_padre> <nombre_archivo> [contenido]" << endl; }
+            break;
+        case Comando::Ls:
+            listar(l, err);
+            break;
+        case Comando::Sort:
+            if (!arg1.empty() && (arg2 == "on" || arg2 == "off")) {
+                cambio = arbol.ordenarCarpeta(arg1, arg2 == "on");
+            } else { err << "Uso: sort <ruta> on|off" << endl; }
+            break;
+        case Comando::Rename:
+            if (!arg1.empty() && !arg2.empty()) {
+                cambio = arbol.renombrarNodo(arg1, arg2);
+            } else { err << "Uso: rename <ruta> <nuevo_nombre>" << endl; }
+            break;
+        case Comando::Rm:
+            if (!arg1.empty()) {
+                cambio = arbol.eliminarNodo(arg1);
+            } else { err << "Uso: rm <ruta>" << endl; }
+            break;
+        case Comando::Papelera:
+            if (arg1.empty()) {
+                arbol.listarPapelera();
+            } else if (arg1 == "limite" && comandos::numero(arg2, valor)) {
+                arbol.limitarPapelera(valor);
+            } else { err << "Uso: papelera [limite <bytes>]" << endl; }
+            break;
+        case Comando::Restore:
+            if (comandos::numero(arg1, valor)) {
+                cambio = arbol.restaurarNodo(valor);
+            } else { err << "Uso: restore <id>" << endl; }
+            break;
+        case Comando::ClearTrash:
+            arbol.vaciarPapelera();
+            break;
+        case Comando::Import:
+            cambio = importar(l, out, err, bytes_contenido);
+            break;
+        case Comando::Undo:
+            cambio = arbol.deshacer();
+            break;
+        case Comando::Redo:
+            cambio = arbol.rehacer();
+            break;
+        case Comando::Historial:
+            if (arg1.empty()) {
+                arbol.mostrarHistorial();
+            } else if (arg1 == "limite" && comandos::numero(arg2, valor)) {
+                arbol.limitarHistorial(valor);
+            } else { err << "Uso: historial [limite <n>]" << endl; }
+            break;
+        case Comando::Hash:
+            if (arg1.empty()) {
+                err << "Uso: hash <ruta>" << endl;
+            } else if (arbol.hashDe(arg1, valor)) {
+                out << merkle::aTexto(valor) << "  " << arg1 << endl;
+            }
+            break;
+        case Comando::Mv:
+            if (!arg1.empty() && !arg2.empty()) {
+                cambio = arbol.moverNodo(arg1, arg2);
+            } else { err << "Uso: mv <ruta_origen> <ruta_destino>" << endl; }
+            break;
+        case Comando::Search:
+            if (!arg1.empty()) {
+                buscar(arg1, out);
+            } else { err << "Uso: search <prefijo_o_nombre>" << endl; }
+            break;
+        case Comando::Export:
+            if (arg1 == "tar") {
+                if (!arg2.empty() && !arg3.empty()) {
+                    exportarTar(string(arg2), string(arg3), out, err);
+                } else { err << "Uso: export tar <ruta> <archivo.tar>" << endl; }
+                break;
+            } else if (arg1 == "preorden") {
+                vector<string> recorrido = arbol.exportarPreorden();
+                out << "\nRecorrido en Preorden:" << endl;
+                // El recorrido en preorden visita la raíz, luego los hijos de izquierda a derecha.
+                // Es un buen método para ver la estructura jerárquica del árbol.
+                //
+                for (const string& s : recorrido) {
+                    out << s << endl;
+                }
+                break;
+            }
+            [[fallthrough]];
+        case Comando::Otro:
+            err << "Comando no reconocido. Escribe 'help' para ver los comandos." << endl;
+            break;
+        }
+        if (cambio) autoguardado.anotar(l.resto(0).size() + bytes_contenido);
+        return true;
+    }
+};
+
+#endif // INTERPRETE_HPP
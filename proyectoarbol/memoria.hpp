@@ -0,0 +1,131 @@
+#ifndef MEMORIA_HPP
+#define MEMORIA_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <iomanip>
+#include <cstddef>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+// ==============================================
+// CONTABILIDAD DE MEMORIA
+// ==============================================
+//
+// Se cuentan los bytes que cada estructura pide al asignador, recorriéndolas: el objeto en sí más
+// cada bloque de heap que posee (buffer de string fuera de la optimización SSO, buffer de vector
+// según su capacidad, nodos de std::map). La cabecera y el redondeo de malloc no se incluyen; para
+// contrastar, el informe muestra también el heap en uso del proceso según el propio malloc.
+
+namespace memoria {
+
+// Bytes de heap de un string: 0 si el texto cabe en el buffer interno (SSO)
+inline size_t bytesString(const string& s) {
+    const char* datos = s.data();
+    const char* objeto = reinterpret_cast<const char*>(&s);
+    bool en_linea = datos >= objeto && datos < objeto + sizeof(string);
+    return en_linea ? 0 : s.capacity() + 1;
+}
+
+template <typename T>
+size_t bytesVector(const vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+// Cada elemento de un std::map es un nodo de árbol rojo-negro: color + 3 punteros + el par
+template <typename K, typename V, typename C>
+size_t bytesNodosMapa(const map<K, V, C>& m) {
+    return m.size() * (4 * sizeof(void*) + sizeof(typename map<K, V, C>::value_type));
+}
+
+// Heap en uso según malloc (0 si la plataforma no lo ofrece)
+inline size_t heapEnUso() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+} // namespace memoria
+
+/**
+ * @brief Bytes y número de objetos de un subsistema.
+ */
+struct Consumo {
+    size_t bytes = 0;
+    size_t objetos = 0;
+
+    Consumo& operator+=(const Consumo& otro) {
+        bytes += otro.bytes;
+        objetos += otro.objetos;
+        return *this;
+    }
+};
+
+/**
+ * @brief Informe de memoria por subsistema (ver ArbolJerarquia::medirMemoria).
+ * * 'arbol' son los Nodo: la parte caliente de 32 bytes (en los bloques de PoolNodos), su DatosNodo
+ *   con el id, la lista de hijos y los índices por carpeta; sin el texto de los archivos, que va
+ *   aparte en 'contenidos'. 'papelera' cuenta los subárboles borrados completos, con su contenido.
+ */
+struct ReporteMemoria {
+    Consumo arbol;       // objetos = nodos
+    Consumo contenidos;  // objetos = archivos con el contenido fuera del objeto (no SSO)
+    Consumo trie;        // objetos = NodoTrie
+    Consumo nombres_trie; // nombres_completos de los NodoTrie; objetos = nombres
+    Consumo mapa_exacto; // objetos = entradas de mapa_busqueda_exacta
+    Consumo papelera;    // objetos = nodos en la papelera
+    Consumo historial;   // Operaciones de deshacer/rehacer y nodos que solo conserva el historial; objetos = operaciones
+    Consumo simbolos;    // Tabla global de nombres internados (compartida por todos los árboles); objetos = símbolos
+    size_t heap_en_uso = 0;
+    size_t subarboles_por_liberar = 0; // Entregados al Reclamador y aún no liberados (siguen en el heap)
+
+    vector<pair<const char*, const Consumo*>> subsistemas() const {
+        return {{"arbol", &arbol}, {"contenidos", &contenidos}, {"trie", &trie},
+                {"nombres_trie", &nombres_trie}, {"mapa_exacto", &mapa_exacto}, {"papelera", &papelera},
+                {"historial", &historial}, {"simbolos", &simbolos}};
+    }
+
+    Consumo total() const {
+        Consumo t;
+        for (const auto& [nombre, consumo] : subsistemas()) t += *consumo;
+        return t;
+    }
+
+    void imprimir(ostream& out) const {
+        auto fila = [&](const char* nombre, const Consumo& c) {
+            out << left << setw(14) << nombre << right << setw(14) << c.bytes << setw(12) << fixed
+                << setprecision(2) << c.bytes / 1048576.0 << setw(12) << c.objetos << '\n';
+        };
+        out << '\n' << left << setw(14) << "subsistema" << right << setw(14) << "bytes" << setw(12) << "MiB"
+            << setw(12) << "objetos" << '\n';
+        for (const auto& [nombre, consumo] : subsistemas()) fila(nombre, *consumo);
+        fila("total", total());
+        if (heap_en_uso) out << "Heap en uso (malloc): " << heap_en_uso << " bytes" << '\n';
+        if (subarboles_por_liberar) out << "Subarboles pendientes de liberar: " << subarboles_por_liberar << '\n';
+        out.flush();
+    }
+
+    // Una línea JSON, apta para adjuntar a informes de benchmarks
+    string aJson() const {
+        string s = "{";
+        for (const auto& [nombre, consumo] : subsistemas()) {
+            s += "\"" + string(nombre) + "\":{\"bytes\":" + to_string(consumo->bytes) +
+                 ",\"objetos\":" + to_string(consumo->objetos) + "},";
+        }
+        Consumo t = total();
+        s += "\"total\":{\"bytes\":" + to_string(t.bytes) + ",\"objetos\":" + to_string(t.objetos) + "},";
+        s += "\"heap_en_uso\":" + to_string(heap_en_uso) + ",";
+        s += "\"subarboles_por_liberar\":" + to_string(subarboles_por_liberar) + "}";
+        return s;
+    }
+};
+
+#endif // MEMORIA_HPP
@@ -0,0 +1,101 @@
+#ifndef MERKLE_HPP
+#define MERKLE_HPP
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+// ==============================================
+// HASH DE SUBÁRBOLES (árbol de Merkle)
+// ==============================================
+//
+// El hash de un nodo resume su nombre, su tipo, su contenido y los hashes de sus hijos: dos
+// subárboles con el mismo hash son iguales salvo colisión (64 bits). Los hijos se combinan con
+// una suma, así que su orden no cuenta: una carpeta es un conjunto de nombres, y restaurar o
+// deshacer puede devolver un hijo a otra posición sin cambiar el contenido.
+//
+// El valor se guarda en las instantáneas: no depende de la plataforma ni de la ejecución (no se
+// usa std::hash) y los bytes se leen siempre como little-endian.
+
+namespace merkle {
+
+constexpr uint64_t K1 = 0x87c37b91114253d5ULL;
+constexpr uint64_t K2 = 0x4cf5ad432745937fULL;
+constexpr uint64_t SEMILLA_CARPETA = 0x9e3779b97f4a7c15ULL;
+constexpr uint64_t SEMILLA_ARCHIVO = 0xc2b2ae3d27d4eb4fULL;
+
+inline uint64_t rotar(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// Mezcla final de MurmurHash3: cada bit de la entrada afecta a todos los de la salida
+inline uint64_t mezclar(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+inline uint64_t leer64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// Hash de un texto: 8 bytes por paso (ronda de un carril de MurmurHash3 x64)
+inline uint64_t hashBytes(string_view s, uint64_t semilla) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+    size_t n = s.size();
+    uint64_t h = semilla ^ (uint64_t(n) * K1);
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t k = rotar(leer64(p) * K1, 31) * K2;
+        h ^= k;
+        h = rotar(h, 27) * 5 + 0x52dce729;
+    }
+    uint64_t resto = 0;
+    for (size_t i = 0; i < n; ++i) resto |= uint64_t(p[i]) << (8 * i);
+    h ^= rotar(resto * K1, 31) * K2;
+    return mezclar(h);
+}
+
+/**
+ * @brief Hash de un nodo a partir de sus datos y de la suma (módulo 2^64) de los hashes de sus hijos.
+ */
+inline uint64_t hashNodo(string_view nombre, bool carpeta, string_view contenido, uint64_t suma_hijos) {
+    uint64_t h = hashBytes(nombre, carpeta ? SEMILLA_CARPETA : SEMILLA_ARCHIVO);
+    h = hashBytes(contenido, h);
+    return mezclar(h ^ mezclar(suma_hijos + K2));
+}
+
+// 16 dígitos hexadecimales en minúscula (formato de las instantáneas y del comando 'hash')
+inline string aTexto(uint64_t hash) {
+    static const char digitos[] = "0123456789abcdef";
+    string s(16, '0');
+    for (int i = 15; i >= 0; --i, hash >>= 4) s[size_t(i)] = digitos[hash & 0xf];
+    return s;
+}
+
+// false si el texto no son exactamente 16 dígitos hexadecimales
+inline bool desdeTexto(string_view s, uint64_t& hash) {
+    if (s.size() != 16) return false;
+    hash = 0;
+    for (char c : s) {
+        int d = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+              : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (d < 0) return false;
+        hash = (hash << 4) | uint64_t(d);
+    }
+    return true;
+}
+
+} // namespace merkle
+
+#endif // MERKLE_HPP
@@ -0,0 +1,283 @@
+#ifndef METRICAS_HPP
+#define METRICAS_HPP
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <iomanip>
+#include <cstdio>
+#include <cstdint>
+
+using namespace std;
+
+// ==============================================
+// METRICAS (contadores e histogramas de latencia)
+// ==============================================
+
+/**
+ * @brief Histograma logarítmico de nanosegundos con contadores atómicos (varios hilos lectores
+ *        de ArbolConcurrente pueden registrar a la vez).
+ * * Cada potencia de dos se divide en 4 cubetas (error relativo < 25%); 252 cubetas en total.
+ * * registrar() son cuatro operaciones atómicas relajadas, sin bloqueos. Para medidas finas fuera
+ *   del camino caliente está HistogramaLatencia (histograma.hpp).
+ */
+class HistogramaAtomico {
+public:
+    static constexpr size_t CUBETAS = 252;
+
+private:
+    array<atomic<uint64_t>, CUBETAS> cubetas{};
+    atomic<uint64_t> total{0};
+    atomic<uint64_t> suma{0};
+    atomic<uint64_t> maximo_{0};
+
+public:
+    static size_t indice(uint64_t ns) {
+        if (ns < 8) return size_t(ns);
+        int e = 63 - __builtin_clzll(ns); // ns >> (e - 2) queda en [4, 8)
+        return size_t(4 * (e - 1)) + ((ns >> (e - 2)) & 3);
+    }
+
+    static uint64_t limiteInferior(size_t i) {
+        if (i < 8) return i;
+        return (4 + i % 4) << (i / 4 - 1);
+    }
+
+    // 'veces' > 1 para una muestra que representa a otras tantas medidas (ver MedidaMuestreada)
+    void registrar(uint64_t ns, uint64_t veces = 1) {
+        cubetas[indice(ns)].fetch_add(veces, memory_order_relaxed);
+        total.fetch_add(veces, memory_order_relaxed);
+        suma.fetch_add(ns * veces, memory_order_relaxed);
+        uint64_t m = maximo_.load(memory_order_relaxed);
+        while (ns > m && !maximo_.compare_exchange_weak(m, ns, memory_order_relaxed)) {}
+    }
+
+    void reiniciar() {
+        for (auto& c : cubetas) c.store(0, memory_order_relaxed);
+        total.store(0, memory_order_relaxed);
+        suma.store(0, memory_order_relaxed);
+        maximo_.store(0, memory_order_relaxed);
+    }
+
+    uint64_t cuenta() const { return total.load(memory_order_relaxed); }
+    uint64_t sumaTotal() const { return suma.load(memory_order_relaxed); }
+    uint64_t maximo() const { return maximo_.load(memory_order_relaxed); }
+
+    // Registros con valor menor que 'limite' (limite debe ser potencia de dos)
+    uint64_t cuentaMenorQue(uint64_t limite) const {
+        uint64_t n = 0;
+        for (size_t i = 0; i < CUBETAS && limiteInferior(i) < limite; ++i) n += cubetas[i].load(memory_order_relaxed);
+        return n;
+    }
+
+    // Límite superior de la cubeta del percentil q, recortado al máximo observado
+    uint64_t percentil(double q) const {
+        uint64_t n = cuenta();
+        if (n == 0) return 0;
+        uint64_t objetivo = max<uint64_t>(1, uint64_t(q * double(n) + 0.5));
+        uint64_t acumulado = 0;
+        for (size_t i = 0; i < CUBETAS; ++i) {
+            acumulado += cubetas[i].load(memory_order_relaxed);
+            if (acumulado >= objetivo) {
+                return i + 1 < CUBETAS ? min(limiteInferior(i + 1) - 1, maximo()) : maximo();
+            }
+        }
+        return maximo();
+    }
+};
+
+// Fases internas del árbol; pueden anidarse (una mutación incluye su resolución de ruta y sus índices)
+enum class Fase { ResolucionRuta, Mutacion, IndicesIncremental, IndicesReconstruccion, Guardar, Cargar, GuardarCaptura };
+
+/**
+ * @brief Registro global de métricas: un histograma por comando del intérprete y otro por fase.
+ */
+class Metricas {
+public:
+    static constexpr array<const char*, 7> FASES = {
+        "resolucion_ruta", "mutacion", "indices_incremental", "indices_reconstruccion", "guardar", "cargar",
+        "guardar_captura"
+    };
+    // El último es el cajón de los comandos no reconocidos
+    static constexpr array<const char*, 26> COMANDOS = {
+        "mkdir", "touch", "mv", "rm", "ls", "rename", "search", "export", "save", "load", "help", "exit",
+        "stats", "mem", "papelera", "restore", "clear_trash", "import", "undo", "redo", "historial", "hash", "diff", "sort",
+        "autosave", "otro"
+    };
+
+private:
+    array<HistogramaAtomico, FASES.size()> fases;
+    array<HistogramaAtomico, COMANDOS.size()> comandos;
+
+public:
+    static Metricas& global() {
+        static Metricas instancia;
+        return instancia;
+    }
+
+    static uint64_t ahora() {
+        return uint64_t(chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    HistogramaAtomico& fase(Fase f) { return fases[size_t(f)]; }
+    HistogramaAtomico& comando(size_t i) { return comandos[i]; }
+
+    void reiniciar() {
+        for (auto& h : fases) h.reiniciar();
+        for (auto& h : comandos) h.reiniciar();
+    }
+
+    /**
+     * @brief Tabla legible para el comando 'stats' (solo las series con registros).
+     */
+    void imprimir(ostream& out) const {
+        auto cabecera = [&](const char* titulo) {
+            out << left << setw(24) << titulo << right << setw(10) << "n" << setw(11) << "p50 us"
+                << setw(11) << "p99 us" << setw(11) << "max us" << setw(12) << "total ms" << '\n';
+        };
+        auto fila = [&](const char* nombre, const HistogramaAtomico& h) {
+            if (h.cuenta() == 0) return;
+            out << left << setw(24) << nombre << right << setw(10) << h.cuenta() << fixed << setprecision(1)
+                << setw(11) << h.percentil(0.50) / 1e3 << setw(11) << h.percentil(0.99) / 1e3
+                << setw(11) << h.maximo() / 1e3 << setw(12) << setprecision(3) << h.sumaTotal() / 1e6 << '\n';
+        };
+        out << '\n';
+        cabecera("comando");
+        for (size_t i = 0; i < COMANDOS.size(); ++i) fila(COMANDOS[i], comandos[i]);
+        cabecera("fase");
+        for (size_t i = 0; i < FASES.size(); ++i) fila(FASES[i], fases[i]);
+        out.flush();
+    }
+
+    /**
+     * @brief Formato de texto de Prometheus: un histograma (segundos) por comando y otro por fase.
+     * * Las cubetas 'le' son potencias de 4 ns entre 256 ns y ~69 s, siempre las mismas.
+     */
+    void escribirPrometheus(ostream& out) const {
+        auto serie = [&](const char* metrica, const char* etiqueta, const char* valor, const HistogramaAtomico& h) {
+            uint64_t n = h.cuenta();
+            for (uint64_t le = 256; le <= (uint64_t(1) << 36); le <<= 2) {
+                out << metrica << "_bucket{" << etiqueta << "=\"" << valor << "\",le=\"" << le / 1e9 << "\"} "
+                    << min(n, h.cuentaMenorQue(le)) << '\n';
+            }
+            out << metrica << "_bucket{" << etiqueta << "=\"" << valor << "\",le=\"+Inf\"} " << n << '\n';
+            out << metrica << "_sum{" << etiqueta << "=\"" << valor << "\"} " << h.sumaTotal() / 1e9 << '\n';
+            out << metrica << "_count{" << etiqueta << "=\"" << valor << "\"} " << n << '\n';
+        };
+        out << setprecision(12); // Límites 'le' exactos y estables entre volcados
+        out << "# HELP proyectoarbol_comando_segundos Latencia de los comandos del interprete.\n";
+        out << "# TYPE proyectoarbol_comando_segundos histogram\n";
+        for (size_t i = 0; i < COMANDOS.size(); ++i) {
+            serie("proyectoarbol_comando_segundos", "comando", COMANDOS[i], comandos[i]);
+        }
+        out << "# HELP proyectoarbol_fase_segundos Latencia de las fases internas del arbol.\n";
+        out << "# TYPE proyectoarbol_fase_segundos histogram\n";
+        for (size_t i = 0; i < FASES.size(); ++i) {
+            serie("proyectoarbol_fase_segundos", "fase", FASES[i], fases[i]);
+        }
+    }
+
+    /**
+     * @brief Escribe el archivo de Prometheus de forma atómica (temporal + rename): el recolector
+     *        nunca ve un archivo a medias.
+     */
+    bool volcarPrometheus(const string& ruta) const {
+        string temporal = ruta + ".tmp";
+        {
+            ofstream o(temporal, ios::trunc);
+            if (!o.is_open()) return false;
+            escribirPrometheus(o);
+            if (!o.good()) return false;
+        }
+        return std::rename(temporal.c_str(), ruta.c_str()) == 0;
+    }
+};
+
+/**
+ * @brief Mide el tiempo de vida del objeto y lo registra en la fase indicada.
+ */
+class MedidaFase {
+private:
+    HistogramaAtomico& histograma;
+    uint64_t inicio;
+
+public:
+    explicit MedidaFase(Fase f) : histograma(Metricas::global().fase(f)), inicio(Metricas::ahora()) {}
+    ~MedidaFase() { histograma.registrar(Metricas::ahora() - inicio); }
+    MedidaFase(const MedidaFase&) = delete;
+    MedidaFase& operator=(const MedidaFase&) = delete;
+};
+
+/**
+ * @brief Como MedidaFase, pero solo mide una de cada MUESTREO construcciones de cada hilo y la
+ *        registra con ese peso (cuentas y totales siguen siendo estimaciones sin sesgo).
+ * * Para fases de cada lectura: sin muestreo, todos los lectores de ArbolConcurrente escribirían
+ *   en las mismas líneas de caché del histograma en cada llamada y dejarían de escalar.
+ */
+class MedidaMuestreada {
+public:
+    static constexpr uint32_t MUESTREO = 64;
+
+private:
+    HistogramaAtomico* histograma = nullptr; // nullptr: esta vez no se mide
+    uint64_t inicio = 0;
+
+public:
+    explicit MedidaMuestreada(Fase f) {
+        thread_local uint32_t llamadas = 0;
+        if (++llamadas % MUESTREO != 0) return;
+        histograma = &Metricas::global().fase(f);
+        inicio = Metricas::ahora();
+    }
+    ~MedidaMuestreada() {
+        if (histograma) histograma->registrar(Metricas::ahora() - inicio, MUESTREO);
+    }
+    MedidaMuestreada(const MedidaMuestreada&) = delete;
+    MedidaMuestreada& operator=(const MedidaMuestreada&) = delete;
+};
+
+/**
+ * @brief Hilo que vuelca las métricas en formato Prometheus cada 'intervalo' y una última vez al parar.
+ */
+class VolcadorMetricas {
+private:
+    string ruta;
+    chrono::milliseconds intervalo;
+    mutex m;
+    condition_variable cv;
+    bool parar = false;
+    thread hilo;
+
+    void bucle() {
+        unique_lock<mutex> lock(m);
+        while (!parar) {
+            cv.wait_for(lock, intervalo, [&] { return parar; });
+            if (!Metricas::global().volcarPrometheus(ruta)) {
+                cerr << "Advertencia: No se pudieron volcar las metricas en " << ruta << endl;
+            }
+        }
+    }
+
+public:
+    VolcadorMetricas(string r, chrono::milliseconds i) : ruta(std::move(r)), intervalo(i) {
+        hilo = thread(&VolcadorMetricas::bucle, this);
+    }
+
+    ~VolcadorMetricas() {
+        {
+            lock_guard<mutex> lock(m);
+            parar = true;
+        }
+        cv.notify_one();
+        hilo.join();
+    }
+};
+
+#endif // METRICAS_HPP
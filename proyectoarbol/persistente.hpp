@@ -0,0 +1,500 @@
+#ifndef PERSISTENTE_HPP
+#define PERSISTENTE_HPP
+
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <stdexcept>
+
+#include "arbol.hpp"
+
+// ==============================================
+// RECLAMACIÓN DE MEMORIA POR ÉPOCAS
+// ==============================================
+
+/**
+ * @brief Reclamación basada en épocas (EBR) compartida por todos los ArbolPersistente del proceso.
+ * * Un lector anuncia la época global al fijar una instantánea y la retira al soltarla.
+ * * Lo que se retira en la época e solo se libera cuando ningún lector activo anuncia una época <= e.
+ */
+class GestorEpocas {
+public:
+    static constexpr size_t MAX_HILOS = 128;
+
+private:
+    // Una ranura por hilo lector, en su propia línea de caché para no compartirla al fijar
+    struct alignas(64) Ranura {
+        atomic<uint64_t> epoca{0}; // 0 = el hilo no tiene ninguna instantánea fijada
+        atomic<bool> ocupada{false};
+    };
+
+    // Ranura asignada al hilo actual; se devuelve al terminar el hilo
+    struct RegistroHilo {
+        GestorEpocas* gestor = nullptr;
+        size_t indice = 0;
+        int anidamiento = 0;
+        ~RegistroHilo() {
+            if (gestor) gestor->ranuras[indice].ocupada.store(false, memory_order_release);
+        }
+    };
+
+    atomic<uint64_t> epoca_global{1};
+    Ranura ranuras[MAX_HILOS];
+
+    GestorEpocas() = default;
+
+    RegistroHilo& registro() {
+        thread_local RegistroHilo r;
+        if (!r.gestor) {
+            for (size_t i = 0; i < MAX_HILOS; ++i) {
+                bool libre = false;
+                if (ranuras[i].ocupada.compare_exchange_strong(libre, true)) {
+                    r.gestor = this;
+                    r.indice = i;
+                    return r;
+                }
+            }
+            throw runtime_error("GestorEpocas: demasiados hilos lectores simultaneos");
+        }
+        return r;
+    }
+
+public:
+    static GestorEpocas& global() {
+        static GestorEpocas gestor;
+        return gestor;
+    }
+
+    // Marca el inicio de una lectura; admite anidamiento dentro del mismo hilo
+    void entrar() {
+        RegistroHilo& r = registro();
+        if (r.anidamiento++ == 0) {
+            // seq_cst: la publicación de la época debe ser visible antes de leer la raíz
+            ranuras[r.indice].epoca.store(epoca_global.load());
+        }
+    }
+
+    void salir() {
+        RegistroHilo& r = registro();
+        if (--r.anidamiento == 0) {
+            ranuras[r.indice].epoca.store(0, memory_order_release);
+        }
+    }
+
+    // Cierra la época actual y devuelve su número (etiqueta de lo retirado en ella)
+    uint64_t avanzar() {
+        return epoca_global.fetch_add(1);
+    }
+
+    // Época más antigua anunciada por un lector activo (UINT64_MAX si no hay ninguno)
+    uint64_t epocaMinimaActiva() const {
+        uint64_t minima = UINT64_MAX;
+        for (const Ranura& ranura : ranuras) {
+            uint64_t e = ranura.epoca.load();
+            if (e != 0 && e < minima) minima = e;
+        }
+        return minima;
+    }
+};
+
+// ==============================================
+// ÁRBOL PERSISTENTE (copia de camino)
+// ==============================================
+
+/**
+ * @brief Nodo inmutable: una vez publicado no se modifica y puede compartirse entre versiones.
+ */
+struct NodoP {
+    string id;
+    string nombre;
+    TipoNodo tipo;
+    string contenido;
+    vector<const NodoP*> hijos; // No es propietario: los hijos pueden pertenecer a varias versiones
+
+    const NodoP* hijo(string_view nombre_hijo) const {
+        for (const NodoP* h : hijos) {
+            if (h->nombre == nombre_hijo) return h;
+        }
+        return nullptr;
+    }
+
+    json aJson() const {
+        json j;
+        j["id"] = id;
+        j["nombre"] = nombre;
+        j["tipo"] = (tipo == TipoNodo::Carpeta ? "carpeta" : "archivo");
+        j["contenido"] = contenido;
+        json j_hijos = json::array();
+        for (const NodoP* h : hijos) {
+            j_hijos.push_back(h->aJson());
+        }
+        j["hijos"] = j_hijos;
+        return j;
+    }
+};
+
+/**
+ * @brief Versión fijada del árbol. Mientras exista, ninguno de sus nodos se libera.
+ * * Fijar y soltar cuesta dos escrituras atómicas; no bloquea ni es bloqueada por escritores.
+ */
+class Instantanea {
+private:
+    const NodoP* raiz_;
+
+public:
+    explicit Instantanea(const atomic<const NodoP*>& raiz_publicada) {
+        GestorEpocas::global().entrar();
+        raiz_ = raiz_publicada.load();
+    }
+    ~Instantanea() { GestorEpocas::global().salir(); }
+
+    Instantanea(const Instantanea&) = delete;
+    Instantanea& operator=(const Instantanea&) = delete;
+
+    const NodoP* raiz() const { return raiz_; }
+
+    // Resuelve una ruta dentro de esta versión (misma sintaxis que ArbolJerarquia)
+    const NodoP* buscar(string_view ruta) const {
+        const NodoP* actual = raiz_;
+        size_t i = 0;
+        while (i < ruta.size()) {
+            if (ruta[i] == '/') { ++i; continue; }
+            size_t fin = ruta.find('/', i);
+            if (fin == string_view::npos) fin = ruta.size();
+            actual = actual->hijo(ruta.substr(i, fin - i));
+            if (!actual) return nullptr;
+            i = fin;
+        }
+        return actual;
+    }
+
+    template <typename Visitante>
+    bool visitarHijos(string_view ruta, Visitante visitante) const {
+        const NodoP* nodo = buscar(ruta);
+        if (!nodo || nodo->tipo != TipoNodo::Carpeta) return false;
+        for (const NodoP* h : nodo->hijos) visitante(*h);
+        return true;
+    }
+};
+
+/**
+ * @brief Árbol de jerarquía con lectores sin bloqueo.
+ * * Cada mutación copia solo el camino desde el nodo cambiado hasta la raíz y publica la nueva raíz
+ *   de forma atómica; los nodos sustituidos se retiran y se liberan por épocas.
+ * * Los escritores se serializan entre sí con un mutex; los lectores nunca lo toman.
+ * * A diferencia de ArbolJerarquia, 'rm' no guarda el subárbol en una papelera.
+ */
+class ArbolPersistente {
+private:
+    atomic<const NodoP*> raiz;
+    mutex mutex_escritura;
+
+    // Todo lo siguiente solo se toca con mutex_escritura
+    vector<pair<uint64_t, const NodoP*>> retirados; // (época de retiro, nodo), en orden de época
+    vector<const NodoP*> por_retirar;               // Sustituidos por la transacción en curso
+    vector<const NodoP*> nuevos;                    // Creados por la transacción en curso (sin publicar)
+
+    NodoP* crear(const NodoP& modelo) {
+        NodoP* copia = new NodoP(modelo);
+        nuevos.push_back(copia);
+        return copia;
+    }
+
+    // Un nodo sustituido se libera ya si nunca se publicó; si no, se retira
+    void descartar(const NodoP* nodo) {
+        auto it = std::find(nuevos.begin(), nuevos.end(), nodo);
+        if (it != nuevos.end()) {
+            nuevos.erase(it);
+            delete nodo;
+        } else {
+            por_retirar.push_back(nodo);
+        }
+    }
+
+    // Retira un subárbol completo que deja de ser alcanzable desde la nueva versión
+    void descartarSubarbol(const NodoP* nodo) {
+        vector<const NodoP*> pila{nodo};
+        while (!pila.empty()) {
+            const NodoP* actual = pila.back();
+            pila.pop_back();
+            pila.insert(pila.end(), actual->hijos.begin(), actual->hijos.end());
+            descartar(actual);
+        }
+    }
+
+    // Resuelve la ruta desde r guardando la cadena de ancestros (r incluido)
+    static bool resolver(const NodoP* r, string_view ruta, vector<const NodoP*>& camino) {
+        camino.assign(1, r);
+        size_t i = 0;
+        while (i < ruta.size()) {
+            if (ruta[i] == '/') { ++i; continue; }
+            size_t fin = ruta.find('/', i);
+            if (fin == string_view::npos) fin = ruta.size();
+            const NodoP* siguiente = camino.back()->hijo(ruta.substr(i, fin - i));
+            if (!siguiente) return false;
+            camino.push_back(siguiente);
+            i = fin;
+        }
+        return true;
+    }
+
+    // Sustituye camino.back() por 'reemplazo' copiando sus ancestros; devuelve la nueva raíz
+    const NodoP* copiarCamino(const vector<const NodoP*>& camino, const NodoP* reemplazo) {
+        const NodoP* anterior = camino.back();
+        descartar(anterior);
+        for (size_t i = camino.size() - 1; i-- > 0;) {
+            NodoP* copia = crear(*camino[i]);
+            std::replace(copia->hijos.begin(), copia->hijos.end(), anterior, reemplazo);
+            anterior = camino[i];
+            descartar(anterior);
+            reemplazo = copia;
+        }
+        return reemplazo;
+    }
+
+    // Publica la nueva raíz, etiqueta lo sustituido con la época actual y libera lo que ya es seguro
+    void publicar(const NodoP* nueva_raiz) {
+        raiz.store(nueva_raiz);
+        uint64_t epoca = GestorEpocas::global().avanzar();
+        for (const NodoP* nodo : por_retirar) retirados.emplace_back(epoca, nodo);
+        por_retirar.clear();
+        nuevos.clear();
+        reclamar();
+    }
+
+    // Libera lo retirado en épocas que ya no tienen lectores activos
+    void reclamar() {
+        uint64_t minima = GestorEpocas::global().epocaMinimaActiva();
+        size_t liberados = 0;
+        while (liberados < retirados.size() && retirados[liberados].first < minima) {
+            delete retirados[liberados].second;
+            ++liberados;
+        }
+        retirados.erase(retirados.begin(), retirados.begin() + liberados);
+    }
+
+    // Deshace una transacción que no llegó a publicarse
+    void abortar() {
+        for (const NodoP* nodo : nuevos) delete nodo;
+        nuevos.clear();
+        por_retirar.clear();
+    }
+
+    static bool existeHermano(const NodoP* padre, string_view nombre, const NodoP* excepto = nullptr) {
+        for (const NodoP* h : padre->hijos) {
+            if (h != excepto && h->nombre == nombre) return true;
+        }
+        return false;
+    }
+
+    // Cada nodo va a 'creados' en cuanto existe: si el JSON falla a medias, quien llama los libera
+    static NodoP* desdeJson(const json& j, vector<const NodoP*>& creados) {
+        creados.push_back(nullptr); // El hueco primero: si push_back lanza, aún no hay nodo que perder
+        NodoP* nodo = new NodoP();
+        creados.back() = nodo;
+        nodo->id = j["id"];
+        nodo->nombre = j["nombre"];
+        nodo->tipo = (j["tipo"] == "carpeta" ? TipoNodo::Carpeta : TipoNodo::Archivo);
+        nodo->contenido = j.value("contenido", "");
+        if (j.contains("hijos")) {
+            for (const auto& j_hijo : j["hijos"]) nodo->hijos.push_back(desdeJson(j_hijo, creados));
+        }
+        return nodo;
+    }
+
+    static NodoP* desdeNodo(const Nodo* n) {
+        NodoP* nodo = new NodoP{n->id(), n->nombre.str(), n->tipo, n->contenido(), {}};
+        nodo->hijos.reserve(n->hijos.size());
+        for (const Nodo* h : n->hijos) nodo->hijos.push_back(desdeNodo(h));
+        return nodo;
+    }
+
+    static NodoP* raizVacia() {
+        return new NodoP{Nodo::generarId("/"), "/", TipoNodo::Carpeta, "", {}};
+    }
+
+    // Sustituye el árbol entero (load / importación)
+    void reemplazarTodo(const NodoP* nueva_raiz) {
+        lock_guard<mutex> candado(mutex_escritura);
+        descartarSubarbol(raiz.load());
+        publicar(nueva_raiz);
+    }
+
+public:
+    ArbolPersistente() : raiz(raizVacia()) {}
+
+    ArbolPersistente(const ArbolPersistente&) = delete;
+    ArbolPersistente& operator=(const ArbolPersistente&) = delete;
+
+    // Requiere que no quede ninguna instantánea viva de este árbol
+    ~ArbolPersistente() {
+        vector<const NodoP*> pila{raiz.load()};
+        while (!pila.empty()) {
+            const NodoP* actual = pila.back();
+            pila.pop_back();
+            pila.insert(pila.end(), actual->hijos.begin(), actual->hijos.end());
+            delete actual;
+        }
+        for (auto& [epoca, nodo] : retirados) delete nodo;
+    }
+
+    // --- Lectura ---
+
+    /**
+     * @brief Fija la versión actual. Uso: `auto s = arbol.instantanea(); s.buscar("/docs");`
+     */
+    Instantanea instantanea() const {
+        return Instantanea(raiz);
+    }
+
+    // --- Escritura (una versión nueva por operación) ---
+
+    bool crearNodo(string_view ruta_padre, const string& nombre, TipoNodo tipo, const string& contenido = "") {
+        lock_guard<mutex> candado(mutex_escritura);
+        vector<const NodoP*> camino;
+        if (!resolver(raiz.load(), ruta_padre, camino) || camino.back()->tipo != TipoNodo::Carpeta) {
+            cerr << "Error: Ruta padre '" << ruta_padre << "' no encontrada o no es una carpeta." << endl;
+            return false;
+        }
+        if (existeHermano(camino.back(), nombre)) {
+            cerr << "Error: Ya existe un nodo con el nombre '" << nombre << "' en esta ruta." << endl;
+            return false;
+        }
+
+        NodoP* padre = crear(*camino.back());
+        padre->hijos.push_back(crear(NodoP{Nodo::generarId(nombre), nombre, tipo, contenido, {}}));
+        publicar(copiarCamino(camino, padre));
+        return true;
+    }
+
+    bool renombrarNodo(string_view ruta, const string& nuevo_nombre) {
+        lock_guard<mutex> candado(mutex_escritura);
+        vector<const NodoP*> camino;
+        if (!resolver(raiz.load(), ruta, camino) || camino.size() < 2) {
+            cerr << "Error: Nodo no encontrado o es la raiz ('/')." << endl;
+            return false;
+        }
+        if (existeHermano(camino[camino.size() - 2], nuevo_nombre, camino.back())) {
+            cerr << "Error: Ya existe un nodo con el nombre '" << nuevo_nombre << "' en este directorio." << endl;
+            return false;
+        }
+
+        NodoP* renombrado = crear(*camino.back());
+        renombrado->nombre = nuevo_nombre;
+        publicar(copiarCamino(camino, renombrado));
+        return true;
+    }
+
+    bool eliminarNodo(string_view ruta) {
+        lock_guard<mutex> candado(mutex_escritura);
+        vector<const NodoP*> camino;
+        if (!resolver(raiz.load(), ruta, camino) || camino.size() < 2) {
+            cerr << "Error: Nodo no encontrado o es la raiz ('/')." << endl;
+            return false;
+        }
+
+        const NodoP* objetivo = camino.back();
+        camino.pop_back();
+        NodoP* padre = crear(*camino.back());
+        padre->hijos.erase(std::find(padre->hijos.begin(), padre->hijos.end(), objetivo));
+        descartarSubarbol(objetivo);
+        publicar(copiarCamino(camino, padre));
+        return true;
+    }
+
+    bool moverNodo(string_view ruta_origen, string_view ruta_destino) {
+        lock_guard<mutex> candado(mutex_escritura);
+        vector<const NodoP*> camino_origen, camino_destino;
+        if (!resolver(raiz.load(), ruta_origen, camino_origen) || camino_origen.size() < 2) {
+            cerr << "Error: Nodo de origen no encontrado o es la raiz." << endl;
+            return false;
+        }
+        if (!resolver(raiz.load(), ruta_destino, camino_destino) || camino_destino.back()->tipo != TipoNodo::Carpeta) {
+            cerr << "Error: Destino no encontrado o no es una carpeta." << endl;
+            return false;
+        }
+        const NodoP* nodo = camino_origen.back();
+        if (std::find(camino_destino.begin(), camino_destino.end(), nodo) != camino_destino.end()) {
+            cerr << "Error: No se puede mover una carpeta a un subdirectorio propio." << endl;
+            return false;
+        }
+        if (existeHermano(camino_destino.back(), nodo->nombre, nodo)) {
+            cerr << "Error: Ya existe un nodo con el nombre '" << nodo->nombre << "' en el destino." << endl;
+            return false;
+        }
+
+        // 1. Versión intermedia (sin publicar) sin el nodo en su padre actual
+        camino_origen.pop_back();
+        NodoP* padre_origen = crear(*camino_origen.back());
+        padre_origen->hijos.erase(std::find(padre_origen->hijos.begin(), padre_origen->hijos.end(), nodo));
+        const NodoP* intermedia = copiarCamino(camino_origen, padre_origen);
+
+        // 2. Sobre ella, añadir el nodo al destino (el nodo y su subárbol se comparten tal cual)
+        if (!resolver(intermedia, ruta_destino, camino_destino)) {
+            abortar();
+            return false;
+        }
+        NodoP* padre_destino = crear(*camino_destino.back());
+        padre_destino->hijos.push_back(nodo);
+        publicar(copiarCamino(camino_destino, padre_destino));
+        return true;
+    }
+
+    // --- Persistencia ---
+
+    /**
+     * @brief Guarda una instantánea: no bloquea ni a lectores ni a escritores.
+     */
+    bool guardar(const string& nombre_archivo = "jerarquia.json") const {
+        try {
+            Instantanea s = instantanea();
+            escribirJsonAtomico(s.raiz()->aJson(), nombre_archivo); // Lanza si no se pudo escribir
+            return true;
+        } catch (const exception& e) {
+            cerr << "Error al guardar el JSON: " << e.what() << endl;
+            return false;
+        }
+    }
+
+    bool cargar(const string& nombre_archivo = "jerarquia.json") {
+        try {
+            ifstream i(nombre_archivo);
+            if (!i.is_open()) {
+                cerr << "Advertencia: Archivo " << nombre_archivo << " no encontrado." << endl;
+                return false;
+            }
+            json j;
+            i >> j;
+            // El árbol actual no se toca hasta tener el nuevo completo
+            vector<const NodoP*> creados;
+            const NodoP* nueva_raiz;
+            try {
+                nueva_raiz = desdeJson(j, creados);
+            } catch (...) {
+                for (const NodoP* nodo : creados) delete nodo;
+                throw;
+            }
+            reemplazarTodo(nueva_raiz);
+            return true;
+        } catch (const exception& e) {
+            cerr << "Error al cargar/parsear el JSON: " << e.what() << endl;
+            return false;
+        }
+    }
+
+    /**
+     * @brief Copia el contenido actual de un ArbolJerarquia (por ejemplo, tras un load normal).
+     */
+    void cargarDesde(const ArbolJerarquia& arbol) {
+        reemplazarTodo(desdeNodo(arbol.obtenerNodo("/")));
+    }
+
+    // Nodos retirados que aún esperan a que los lectores antiguos suelten su instantánea
+    size_t pendientesDeLiberar() {
+        lock_guard<mutex> candado(mutex_escritura);
+        reclamar();
+        return retirados.size();
+    }
+};
+
+#endif // PERSISTENTE_HPP
@@ -0,0 +1,81 @@
+#ifndef PROTOCOLO_HPP
+#define PROTOCOLO_HPP
+
+// Protocolo del servidor de proyectoarbol sobre socket de dominio Unix:
+//  - Petición: una línea de comando terminada en '\n' (se pueden encadenar varias sin esperar respuesta).
+//  - Respuesta: 4 bytes de longitud (little-endian) seguidos del texto que la consola habría impreso.
+//  Las respuestas llegan en el mismo orden que las peticiones.
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace protocolo {
+
+constexpr const char* SOCKET_POR_DEFECTO = "/tmp/proyectoarbol.sock";
+constexpr size_t BYTES_CABECERA = 4;
+
+inline void escribirLongitud(char* destino, uint32_t n) {
+    destino[0] = char(n & 0xff);
+    destino[1] = char((n >> 8) & 0xff);
+    destino[2] = char((n >> 16) & 0xff);
+    destino[3] = char((n >> 24) & 0xff);
+}
+
+inline uint32_t leerLongitud(const char* origen) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(origen);
+    return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+}
+
+/**
+ * @brief Extrae la siguiente respuesta completa de 'buffer' a partir de 'pos'.
+ * @return false si todavía no ha llegado entera (pos no se modifica).
+ */
+inline bool extraerRespuesta(const std::string& buffer, size_t& pos, std::string_view& texto) {
+    if (buffer.size() - pos < BYTES_CABECERA) return false;
+    uint32_t n = leerLongitud(buffer.data() + pos);
+    if (buffer.size() - pos - BYTES_CABECERA < n) return false;
+    texto = std::string_view(buffer.data() + pos + BYTES_CABECERA, n);
+    pos += BYTES_CABECERA + n;
+    return true;
+}
+
+// Rellena la dirección de un socket Unix; false si la ruta no cabe
+inline bool direccion(const std::string& ruta, sockaddr_un& dir) {
+    std::memset(&dir, 0, sizeof(dir));
+    dir.sun_family = AF_UNIX;
+    if (ruta.size() >= sizeof(dir.sun_path)) return false;
+    std::memcpy(dir.sun_path, ruta.c_str(), ruta.size() + 1);
+    return true;
+}
+
+// Conecta (bloqueante) con el servidor; -1 si falla
+inline int conectar(const std::string& ruta) {
+    sockaddr_un dir;
+    if (!direccion(ruta, dir)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Envía todo el bloque (bloqueante); false si la conexión se cerró
+inline bool enviarTodo(int fd, std::string_view datos) {
+    while (!datos.empty()) {
+        ssize_t n = send(fd, datos.data(), datos.size(), MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        datos.remove_prefix(size_t(n));
+    }
+    return true;
+}
+
+} // namespace protocolo
+
+#endif // PROTOCOLO_HPP
@@ -0,0 +1,295 @@
+#ifndef SERVIDOR_HPP
+#define SERVIDOR_HPP
+
+#include <unordered_map>
+#include <csignal>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+
+#include "interprete.hpp"
+#include "protocolo.hpp"
+
+// ==============================================
+// MODO SERVIDOR (socket Unix + epoll)
+// ==============================================
+
+/**
+ * @brief streambuf que añade lo escrito al final de un string (sin copias intermedias).
+ */
+class BufferRespuesta : public streambuf {
+private:
+    string* destino = nullptr;
+
+protected:
+    int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) destino->push_back(char(c));
+        return c;
+    }
+    streamsize xsputn(const char* s, streamsize n) override {
+        destino->append(s, size_t(n));
+        return n;
+    }
+
+public:
+    void apuntarA(string& d) { destino = &d; }
+};
+
+/**
+ * @brief Servidor de un solo hilo que mantiene el árbol en memoria y atiende muchos clientes.
+ * * Cada conexión puede encadenar peticiones; se ejecutan en orden y las respuestas se acumulan en
+ *   su buffer de salida, que se vacía cuando el socket admite escritura (EPOLLOUT).
+ * * Contrapresión: con más de MAX_SALIDA bytes sin enviar, la conexión deja de ejecutar líneas y de
+ *   leer (sin EPOLLIN) hasta que el cliente lea sus respuestas; un cliente que encadena peticiones
+ *   sin leer no hace crecer la memoria del servidor sin límite.
+ */
+class Servidor {
+private:
+    struct Conexion {
+        string entrada;          // Bytes recibidos aún sin línea completa
+        string salida;           // Respuestas pendientes de enviar
+        size_t enviado = 0;      // Parte de 'salida' ya enviada
+        bool cerrar = false;     // Cerrar cuando se haya enviado todo
+        bool sin_entrada = false; // El cliente cerró su lado: solo quedan las líneas ya recibidas
+        uint32_t mascara = EPOLLIN | EPOLLRDHUP; // Eventos vigilados ahora mismo
+    };
+
+    static constexpr size_t MAX_LINEA = 1 << 20;   // Una petición sin '\n' mayor que esto cierra la conexión
+    static constexpr size_t MAX_SALIDA = 4 << 20;  // Respuestas sin enviar a partir de las que se deja de atender
+    static constexpr size_t BYTES_LECTURA = 64 * 1024;
+    static constexpr int MS_AUTOGUARDADO = 1000;     // Sin peticiones, cada cuánto se revisa el autoguardado
+
+    Interprete& interprete;
+    string ruta_socket;
+    int fd_escucha = -1;
+    int fd_epoll = -1;
+    unordered_map<int, Conexion> conexiones;
+    BufferRespuesta buffer_respuesta;
+    ostream respuesta{&buffer_respuesta};
+    size_t peticiones_atendidas = 0;
+
+    static volatile sig_atomic_t& detener() {
+        static volatile sig_atomic_t bandera = 0;
+        return bandera;
+    }
+    static void manejarSenal(int) { detener() = 1; }
+
+    static bool noBloqueante(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    void vigilar(int fd, uint32_t eventos, int operacion) {
+        epoll_event ev{};
+        ev.events = eventos;
+        ev.data.fd = fd;
+        epoll_ctl(fd_epoll, operacion, fd, &ev);
+    }
+
+    void cerrarConexion(int fd) {
+        epoll_ctl(fd_epoll, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        conexiones.erase(fd);
+    }
+
+    // Solo un socket huérfano de una ejecución anterior se puede borrar: ni un archivo normal (una
+    // ruta mal escrita) ni el socket de un servidor que sigue vivo
+    static bool liberarRuta(const string& ruta, const sockaddr_un& dir) {
+        struct stat st;
+        if (lstat(ruta.c_str(), &st) < 0) {
+            if (errno == ENOENT) return true;
+            cerr << "Error: No se pudo comprobar " << ruta << ": " << strerror(errno) << endl;
+            return false;
+        }
+        if (!S_ISSOCK(st.st_mode)) {
+            cerr << "Error: " << ruta << " existe y no es un socket." << endl;
+            return false;
+        }
+        int prueba = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool huerfano = prueba >= 0 && connect(prueba, reinterpret_cast<const sockaddr*>(&dir), sizeof(dir)) < 0 &&
+                        errno == ECONNREFUSED;
+        if (prueba >= 0) close(prueba);
+        if (!huerfano) {
+            cerr << "Error: El socket " << ruta << " esta en uso." << endl;
+            return false;
+        }
+        return unlink(ruta.c_str()) == 0 || errno == ENOENT;
+    }
+
+    void aceptar() {
+        while (true) {
+            int fd = accept(fd_escucha, nullptr, nullptr);
+            if (fd < 0) return; // EAGAIN: no quedan conexiones pendientes
+            if (!noBloqueante(fd)) {
+                close(fd);
+                continue;
+            }
+            conexiones.emplace(fd, Conexion{});
+            vigilar(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD);
+        }
+    }
+
+    static bool saturada(const Conexion& c) { return c.salida.size() - c.enviado > MAX_SALIDA; }
+
+    // Ejecuta cada línea completa del buffer de entrada y encola su respuesta, hasta que la salida
+    // pendiente pase de MAX_SALIDA (el resto espera en 'entrada' a que vaciar() la baje)
+    void atender(Conexion& c) {
+        size_t inicio = 0;
+        size_t fin;
+        while (!c.cerrar && !saturada(c) && (fin = c.entrada.find('\n', inicio)) != string::npos) {
+            size_t largo = fin - inicio;
+            if (largo > 0 && c.entrada[fin - 1] == '\r') --largo;
+            string linea = c.entrada.substr(inicio, largo);
+            inicio = fin + 1;
+
+            // Cabecera provisional; la longitud real se escribe al terminar el comando
+            size_t cabecera = c.salida.size();
+            c.salida.append(protocolo::BYTES_CABECERA, '\0');
+            buffer_respuesta.apuntarA(c.salida);
+            if (!interprete.ejecutar(linea, respuesta, respuesta)) c.cerrar = true; // 'exit' cierra solo este cliente
+            respuesta.flush();
+            protocolo::escribirLongitud(&c.salida[cabecera],
+                                        uint32_t(c.salida.size() - cabecera - protocolo::BYTES_CABECERA));
+            ++peticiones_atendidas;
+        }
+        c.entrada.erase(0, inicio);
+        bool linea_completa = c.entrada.find('\n') != string::npos; // Solo si se paró por la salida
+        if (!linea_completa && (c.sin_entrada || c.entrada.size() > MAX_LINEA)) c.cerrar = true;
+    }
+
+    // Envía lo pendiente; devuelve false si la conexión debe cerrarse ya
+    bool vaciar(int fd, Conexion& c) {
+        while (c.enviado < c.salida.size()) {
+            ssize_t n = send(fd, c.salida.data() + c.enviado, c.salida.size() - c.enviado, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                if (errno == EINTR) continue;
+                return false;
+            }
+            c.enviado += size_t(n);
+        }
+        if (c.enviado == c.salida.size()) {
+            c.salida.clear();
+            c.enviado = 0;
+        }
+        // Con la salida por debajo del tope se reanudan las líneas que se quedaron esperando
+        if (!c.cerrar && !saturada(c)) atender(c);
+        if (c.cerrar && c.salida.empty()) return false;
+
+        // Sin leer tras el cierre de entrada ni con la salida saturada: solo interesa poder escribir
+        bool leer_mas = !c.cerrar && !c.sin_entrada && !saturada(c);
+        uint32_t mascara = (leer_mas ? uint32_t(EPOLLIN | EPOLLRDHUP) : 0u) | (c.salida.empty() ? 0u : uint32_t(EPOLLOUT));
+        if (mascara != c.mascara) {
+            c.mascara = mascara;
+            vigilar(fd, mascara, EPOLL_CTL_MOD);
+        }
+        return true;
+    }
+
+    void leer(int fd, Conexion& c) {
+        char bloque[BYTES_LECTURA];
+        while (true) {
+            ssize_t n = recv(fd, bloque, sizeof(bloque), 0);
+            if (n > 0) {
+                c.entrada.append(bloque, size_t(n));
+                // Lo demás se lee en la siguiente vuelta (EPOLLIN sigue activo mientras quede algo)
+                if (size_t(n) < sizeof(bloque) || c.entrada.size() > MAX_LINEA) break;
+                continue;
+            }
+            if (n == 0) c.sin_entrada = true; // El cliente no enviará más: responder lo pendiente y cerrar
+            else if (errno == EINTR) continue;
+            else if (errno != EAGAIN && errno != EWOULDBLOCK) c.sin_entrada = true;
+            break;
+        }
+        atender(c);
+    }
+
+public:
+    Servidor(Interprete& i, string ruta = protocolo::SOCKET_POR_DEFECTO)
+        : interprete(i), ruta_socket(std::move(ruta)) {}
+
+    ~Servidor() {
+        for (auto& [fd, c] : conexiones) close(fd);
+        if (fd_epoll >= 0) close(fd_epoll);
+        if (fd_escucha >= 0) {
+            close(fd_escucha);
+            unlink(ruta_socket.c_str());
+        }
+    }
+
+    /**
+     * @brief Crea el socket de escucha; false (con mensaje en cerr) si no es posible.
+     */
+    bool iniciar() {
+        sockaddr_un dir;
+        if (!protocolo::direccion(ruta_socket, dir)) {
+            cerr << "Error: Ruta de socket demasiado larga: " << ruta_socket << endl;
+            return false;
+        }
+        if (!liberarRuta(ruta_socket, dir)) return false;
+        fd_escucha = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd_escucha < 0) {
+            cerr << "Error: No se pudo crear el socket: " << strerror(errno) << endl;
+            return false;
+        }
+        if (bind(fd_escucha, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) < 0 ||
+            listen(fd_escucha, SOMAXCONN) < 0 || !noBloqueante(fd_escucha)) {
+            cerr << "Error: No se pudo escuchar en " << ruta_socket << ": " << strerror(errno) << endl;
+            close(fd_escucha);
+            fd_escucha = -1;
+            return false;
+        }
+
+        fd_epoll = epoll_create1(0);
+        if (fd_epoll < 0) {
+            cerr << "Error: epoll_create1: " << strerror(errno) << endl;
+            return false;
+        }
+        vigilar(fd_escucha, EPOLLIN, EPOLL_CTL_ADD);
+
+        // SIGINT/SIGTERM terminan el bucle; sin SA_RESTART para que interrumpan epoll_wait
+        struct sigaction accion{};
+        accion.sa_handler = manejarSenal;
+        sigemptyset(&accion.sa_mask);
+        sigaction(SIGINT, &accion, nullptr);
+        sigaction(SIGTERM, &accion, nullptr);
+        signal(SIGPIPE, SIG_IGN);
+        return true;
+    }
+
+    /**
+     * @brief Bucle de eventos; vuelve al recibir SIGINT o SIGTERM.
+     */
+    void ejecutar() {
+        constexpr int MAX_EVENTOS = 128;
+        epoll_event eventos[MAX_EVENTOS];
+
+        while (!detener()) {
+            int n = epoll_wait(fd_epoll, eventos, MAX_EVENTOS, MS_AUTOGUARDADO);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                cerr << "Error: epoll_wait: " << strerror(errno) << endl;
+                break;
+            }
+            if (n == 0) interprete.revisarAutoguardado(cerr); // El umbral de tiempo salta aunque no haya comandos
+            for (int i = 0; i < n; ++i) {
+                int fd = eventos[i].data.fd;
+                if (fd == fd_escucha) {
+                    aceptar();
+                    continue;
+                }
+                auto it = conexiones.find(fd);
+                if (it == conexiones.end()) continue;
+                Conexion& c = it->second;
+
+                if (eventos[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) leer(fd, c);
+                if (!vaciar(fd, c)) cerrarConexion(fd);
+            }
+        }
+    }
+
+    size_t peticiones() const { return peticiones_atendidas; }
+};
+
+#endif // SERVIDOR_HPP
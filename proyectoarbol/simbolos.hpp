@@ -0,0 +1,249 @@
+#ifndef SIMBOLOS_HPP
+#define SIMBOLOS_HPP
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <functional>
+
+#include "memoria.hpp"
+
+using namespace std;
+
+// ==============================================
+// INTERNADO DE NOMBRES (tabla global de símbolos)
+// ==============================================
+
+using Simbolo = uint32_t;
+constexpr Simbolo SIN_SIMBOLO = UINT32_MAX;
+
+/**
+ * @brief Tabla global que asigna a cada nombre distinto un Simbolo de 32 bits.
+ * * Cada texto se guarda una sola vez en bloques que nunca se mueven: los string_view devueltos por
+ *   texto() son estables durante toda la vida del programa. La tabla solo crece (un nombre que deja
+ *   de usarse conserva su símbolo).
+ * * texto() y buscar() no toman candados: varios hilos lectores pueden resolver nombres mientras
+ *   otro hilo interna nombres nuevos (internar() se serializa con un mutex).
+ * * El índice inverso es una tabla de direccionamiento abierto con ranuras atómicas de 64 bits
+ *   (hash de 32 bits | símbolo + 1). Al crecer se publica una tabla nueva; las anteriores se
+ *   conservan hasta el final para que un lector rezagado nunca lea memoria liberada (su tamaño
+ *   suma menos que el de la tabla vigente).
+ */
+class TablaSimbolos {
+private:
+    static constexpr int BITS_BLOQUE = 12;                      // 4096 símbolos por bloque del directorio
+    static constexpr size_t TAM_BLOQUE = size_t(1) << BITS_BLOQUE;
+    static constexpr size_t MAX_BLOQUES = size_t(1) << 16;      // Hasta 2^28 símbolos
+    static constexpr size_t TAM_ARENA = 64 * 1024;              // Bloques de texto
+
+    struct Ranuras {
+        size_t mascara;
+        unique_ptr<atomic<uint64_t>[]> ranuras;
+        explicit Ranuras(size_t capacidad) : mascara(capacidad - 1), ranuras(new atomic<uint64_t>[capacidad]) {
+            for (size_t i = 0; i < capacidad; ++i) ranuras[i].store(0, memory_order_relaxed);
+        }
+    };
+
+    // Directorio de bloques: cada entrada apunta al texto, precedido por su longitud (uint32_t)
+    array<atomic<const char**>, MAX_BLOQUES> directorio{};
+    atomic<Ranuras*> indice{nullptr};
+    atomic<size_t> cantidad{0};
+
+    // Solo los toca quien tiene mutex_insercion
+    mutex mutex_insercion;
+    vector<unique_ptr<const char*[]>> bloques;
+    vector<unique_ptr<Ranuras>> indices; // El último es el vigente
+    vector<unique_ptr<char[]>> arenas;   // La última es la que se está llenando
+    vector<unique_ptr<char[]>> grandes;  // Nombres enormes, cada uno en su propio bloque
+    size_t usado_arena = TAM_ARENA;
+    size_t bytes_arenas = 0;
+
+    static uint32_t hashTexto(string_view s) {
+        return uint32_t(std::hash<string_view>{}(s));
+    }
+
+    const char* entrada(Simbolo s) const {
+        return directorio[s >> BITS_BLOQUE].load(memory_order_acquire)[s & (TAM_BLOQUE - 1)];
+    }
+
+    // Copia el texto a la arena, precedido por su longitud
+    const char* copiarTexto(string_view s) {
+        size_t necesario = sizeof(uint32_t) + s.size();
+        char* destino;
+        if (necesario > TAM_ARENA / 4) { // Nombres enormes: bloque propio
+            grandes.emplace_back(new char[necesario]);
+            bytes_arenas += necesario;
+            destino = grandes.back().get();
+        } else {
+            if (usado_arena + necesario > TAM_ARENA) {
+                arenas.emplace_back(new char[TAM_ARENA]);
+                bytes_arenas += TAM_ARENA;
+                usado_arena = 0;
+            }
+            destino = arenas.back().get() + usado_arena;
+            usado_arena += necesario;
+        }
+        uint32_t largo = uint32_t(s.size());
+        memcpy(destino, &largo, sizeof(largo));
+        memcpy(destino + sizeof(largo), s.data(), s.size());
+        return destino + sizeof(largo);
+    }
+
+    static void colocar(Ranuras& r, uint32_t hash, Simbolo s) {
+        uint64_t valor = (uint64_t(hash) << 32) | (uint64_t(s) + 1);
+        for (size_t i = hash & r.mascara;; i = (i + 1) & r.mascara) {
+            if (r.ranuras[i].load(memory_order_relaxed) == 0) {
+                r.ranuras[i].store(valor, memory_order_release);
+                return;
+            }
+        }
+    }
+
+    Simbolo buscarCon(string_view s, uint32_t hash) const {
+        const Ranuras* r = indice.load(memory_order_acquire);
+        for (size_t i = hash & r->mascara;; i = (i + 1) & r->mascara) {
+            uint64_t valor = r->ranuras[i].load(memory_order_acquire);
+            if (valor == 0) return SIN_SIMBOLO;
+            if (uint32_t(valor >> 32) == hash) {
+                Simbolo simbolo = Simbolo(uint32_t(valor) - 1);
+                if (texto(simbolo) == s) return simbolo;
+            }
+        }
+    }
+
+public:
+    TablaSimbolos() {
+        lock_guard<mutex> candado(mutex_insercion);
+        indices.push_back(make_unique<Ranuras>(1024));
+        indice.store(indices.back().get(), memory_order_release);
+    }
+
+    TablaSimbolos(const TablaSimbolos&) = delete;
+    TablaSimbolos& operator=(const TablaSimbolos&) = delete;
+
+    static TablaSimbolos& global() {
+        static TablaSimbolos instancia;
+        return instancia;
+    }
+
+    string_view texto(Simbolo s) const {
+        const char* p = entrada(s);
+        uint32_t largo;
+        memcpy(&largo, p - sizeof(largo), sizeof(largo));
+        return string_view(p, largo);
+    }
+
+    /**
+     * @brief Símbolo de un nombre ya internado, o SIN_SIMBOLO (no inserta nada).
+     */
+    Simbolo buscar(string_view s) const {
+        return buscarCon(s, hashTexto(s));
+    }
+
+    /**
+     * @brief Símbolo del nombre, creándolo si es la primera vez que aparece.
+     */
+    Simbolo internar(string_view s) {
+        uint32_t hash = hashTexto(s);
+        Simbolo existente = buscarCon(s, hash);
+        if (existente != SIN_SIMBOLO) return existente;
+
+        lock_guard<mutex> candado(mutex_insercion);
+        existente = buscarCon(s, hash); // Otro hilo pudo internarlo mientras esperábamos
+        if (existente != SIN_SIMBOLO) return existente;
+
+        size_t n = cantidad.load(memory_order_relaxed);
+        if (n >= MAX_BLOQUES * TAM_BLOQUE - 1) throw length_error("TablaSimbolos: demasiados nombres distintos");
+        if ((n & (TAM_BLOQUE - 1)) == 0) {
+            bloques.emplace_back(new const char*[TAM_BLOQUE]);
+            directorio[n >> BITS_BLOQUE].store(bloques.back().get(), memory_order_release);
+        }
+        Simbolo nuevo = Simbolo(n);
+        bloques.back()[n & (TAM_BLOQUE - 1)] = copiarTexto(s);
+
+        // Factor de carga máximo 1/2: al superarlo se publica un índice del doble de tamaño
+        Ranuras* actual = indices.back().get();
+        if (2 * (n + 1) > actual->mascara + 1) {
+            auto mayor = make_unique<Ranuras>(2 * (actual->mascara + 1));
+            for (size_t i = 0; i <= actual->mascara; ++i) {
+                uint64_t valor = actual->ranuras[i].load(memory_order_relaxed);
+                if (valor) colocar(*mayor, uint32_t(valor >> 32), Simbolo(uint32_t(valor) - 1));
+            }
+            indices.push_back(std::move(mayor));
+            actual = indices.back().get();
+        }
+        colocar(*actual, hash, nuevo);
+        cantidad.store(n + 1, memory_order_release);
+        indice.store(actual, memory_order_release);
+        return nuevo;
+    }
+
+    size_t simbolos() const { return cantidad.load(memory_order_acquire); }
+
+    /**
+     * @brief Memoria de la tabla: textos, directorio, bloques de entradas e índices (también los retirados).
+     */
+    Consumo medirMemoria() {
+        lock_guard<mutex> candado(mutex_insercion);
+        Consumo c;
+        c.objetos = cantidad.load(memory_order_relaxed);
+        c.bytes = sizeof(TablaSimbolos) + bytes_arenas + memoria::bytesVector(arenas) + memoria::bytesVector(grandes) +
+                  bloques.size() * TAM_BLOQUE * sizeof(const char*) + memoria::bytesVector(bloques) +
+                  memoria::bytesVector(indices);
+        for (const auto& r : indices) c.bytes += sizeof(Ranuras) + (r->mascara + 1) * sizeof(atomic<uint64_t>);
+        return c;
+    }
+};
+
+/**
+ * @brief Nombre internado: 4 bytes. Dos Nombre se comparan como enteros; contra un texto se
+ *        compara el texto (sin internarlo).
+ * * Los constructores son explícitos para que una comparación con un string cualquiera no
+ *   añada ese texto a la tabla global.
+ */
+class Nombre {
+private:
+    Simbolo simbolo_;
+
+public:
+    Nombre() : simbolo_(TablaSimbolos::global().internar("")) {}
+    explicit Nombre(string_view s) : simbolo_(TablaSimbolos::global().internar(s)) {}
+    explicit Nombre(const string& s) : Nombre(string_view(s)) {}
+    explicit Nombre(const char* s) : Nombre(string_view(s)) {}
+
+    Nombre& operator=(string_view s) {
+        simbolo_ = TablaSimbolos::global().internar(s);
+        return *this;
+    }
+    Nombre& operator=(const string& s) { return *this = string_view(s); }
+    Nombre& operator=(const char* s) { return *this = string_view(s); }
+
+    Simbolo simbolo() const { return simbolo_; }
+    string_view vista() const { return TablaSimbolos::global().texto(simbolo_); }
+    string str() const { return string(vista()); }
+    operator string_view() const { return vista(); }
+
+    friend bool operator==(Nombre a, Nombre b) { return a.simbolo_ == b.simbolo_; }
+    friend bool operator!=(Nombre a, Nombre b) { return a.simbolo_ != b.simbolo_; }
+    friend bool operator==(Nombre a, string_view b) { return a.vista() == b; }
+    friend bool operator!=(Nombre a, string_view b) { return a.vista() != b; }
+    friend bool operator==(Nombre a, const string& b) { return a.vista() == b; }
+    friend bool operator!=(Nombre a, const string& b) { return a.vista() != b; }
+    friend bool operator==(Nombre a, const char* b) { return a.vista() == b; }
+    friend bool operator!=(Nombre a, const char* b) { return a.vista() != b; }
+
+    friend ostream& operator<<(ostream& out, Nombre n) { return out << n.vista(); }
+    friend string operator+(const string& a, Nombre b) { return a + b.str(); }
+    friend string operator+(Nombre a, const string& b) { return a.str() + b; }
+    friend string operator+(Nombre a, const char* b) { return a.str() + b; }
+};
+
+#endif // SIMBOLOS_HPP
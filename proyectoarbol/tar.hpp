@@ -0,0 +1,427 @@
+#ifndef TAR_HPP
+#define TAR_HPP
+
+#include <fstream>
+#include <unordered_map>
+#include <chrono>
+#include <cstring>
+#include <cstddef>
+#include <ctime>
+
+#include "arbol.hpp"
+
+// ==============================================
+// ARCHIVOS TAR (ustar + extensiones pax)
+// ==============================================
+//
+// Cada nodo es una cabecera de 512 bytes seguida, en los archivos, de su contenido rellenado hasta
+// múltiplo de 512. Las rutas que no caben en los campos name/prefix de ustar (y los tamaños de 8 GiB
+// o más) van en una cabecera pax ('x') previa. El archivo termina con dos bloques de ceros.
+
+namespace tar {
+
+constexpr size_t BLOQUE = 512;
+constexpr size_t TAM_BUFFER = 1 << 20; // Buffer de escritura y de lectura (cota de memoria, no del archivo)
+
+struct Cabecera {
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char chksum[8];
+    char typeflag;
+    char linkname[100];
+    char magic[6];
+    char version[2];
+    char uname[32];
+    char gname[32];
+    char devmajor[8];
+    char devminor[8];
+    char prefix[155];
+    char relleno[12];
+};
+static_assert(sizeof(Cabecera) == BLOQUE, "una cabecera tar ocupa un bloque");
+
+// Campo numérico en octal, terminado en NUL; false si no cabe
+inline bool escribirOctal(char* campo, size_t ancho, uint64_t valor) {
+    for (size_t i = ancho - 1; i-- > 0;) {
+        campo[i] = char('0' + (valor & 7));
+        valor >>= 3;
+    }
+    campo[ancho - 1] = '\0';
+    return valor == 0;
+}
+
+// Campo numérico en octal (o en base 256, extensión GNU para tamaños grandes)
+inline uint64_t leerNumero(const char* campo, size_t ancho) {
+    uint64_t valor = 0;
+    if (static_cast<unsigned char>(campo[0]) & 0x80) {
+        for (size_t i = 1; i < ancho; ++i) valor = (valor << 8) | static_cast<unsigned char>(campo[i]);
+        return valor;
+    }
+    for (size_t i = 0; i < ancho && campo[i]; ++i) {
+        if (campo[i] >= '0' && campo[i] <= '7') valor = (valor << 3) | uint64_t(campo[i] - '0');
+    }
+    return valor;
+}
+
+inline unsigned sumaControl(const Cabecera& c) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(&c);
+    unsigned suma = 0;
+    for (size_t i = 0; i < BLOQUE; ++i) {
+        bool en_campo = i >= offsetof(Cabecera, chksum) && i < offsetof(Cabecera, chksum) + sizeof(c.chksum);
+        suma += en_campo ? unsigned(' ') : p[i];
+    }
+    return suma;
+}
+
+// Texto de un campo que puede ocupar todo su ancho sin NUL final
+inline string_view campoTexto(const char* campo, size_t ancho) {
+    return string_view(campo, strnlen(campo, ancho));
+}
+
+// Registro pax "<longitud> clave=valor\n", donde la longitud se cuenta a sí misma
+inline string registroPax(string_view clave, string_view valor) {
+    size_t resto = 1 + clave.size() + 1 + valor.size() + 1; // ' ', '=', '\n'
+    size_t largo = resto + 1;
+    while (to_string(largo).size() + resto != largo) largo = to_string(largo).size() + resto;
+    return to_string(largo) + " " + string(clave) + "=" + string(valor) + "\n";
+}
+
+} // namespace tar
+
+/**
+ * @brief Cifras de una exportación o importación tar.
+ */
+struct ResultadoTar {
+    size_t carpetas = 0;
+    size_t archivos = 0;
+    size_t omitidos = 0;       // Importación: enlaces, dispositivos y otros tipos que el árbol no representa
+    uint64_t bytes_contenido = 0;
+    uint64_t bytes_archivo = 0; // Tamaño del .tar escrito o leído
+    double segundos = 0;
+};
+
+/**
+ * @brief Escribe un .tar en streaming: las cabeceras y los contenidos pasan por un buffer fijo.
+ */
+class EscritorTar {
+private:
+    ofstream archivo;
+    vector<char> buffer;
+    uint64_t escritos = 0;
+    time_t instante = time(nullptr);
+
+    bool escribir(const char* datos, size_t n) {
+        while (n > 0) {
+            if (buffer.size() == tar::TAM_BUFFER && !vaciarBuffer()) return false;
+            size_t cabe = min(n, tar::TAM_BUFFER - buffer.size());
+            buffer.insert(buffer.end(), datos, datos + cabe);
+            datos += cabe;
+            n -= cabe;
+        }
+        return true;
+    }
+
+    bool rellenar(uint64_t n) {
+        static const char ceros[tar::BLOQUE] = {};
+        size_t resto = size_t(n % tar::BLOQUE);
+        return resto == 0 || escribir(ceros, tar::BLOQUE - resto);
+    }
+
+    bool vaciarBuffer() {
+        archivo.write(buffer.data(), streamsize(buffer.size()));
+        escritos += buffer.size();
+        buffer.clear();
+        return archivo.good();
+    }
+
+    bool cabecera(string_view ruta, char tipo, uint64_t tamano) {
+        tar::Cabecera c{};
+        string pax;
+        // ustar: nombre de hasta 100 bytes, o prefijo (hasta 155) + '/' + nombre
+        bool cabe = ruta.size() <= sizeof(c.name);
+        size_t corte = string_view::npos;
+        if (!cabe && ruta.size() <= sizeof(c.prefix) + 1 + sizeof(c.name)) {
+            corte = ruta.rfind('/', sizeof(c.prefix));
+            cabe = corte != string_view::npos && corte > 0 && ruta.size() - corte - 1 <= sizeof(c.name) &&
+                   ruta.size() - corte - 1 > 0;
+        }
+        if (cabe && corte != string_view::npos) {
+            memcpy(c.prefix, ruta.data(), corte);
+            memcpy(c.name, ruta.data() + corte + 1, ruta.size() - corte - 1);
+        } else if (cabe) {
+            memcpy(c.name, ruta.data(), ruta.size());
+        } else {
+            pax += tar::registroPax("path", ruta);
+            memcpy(c.name, ruta.data(), min(ruta.size(), sizeof(c.name))); // Truncado para lectores sin pax
+        }
+        if (!tar::escribirOctal(c.size, sizeof(c.size), tamano)) {
+            pax += tar::registroPax("size", to_string(tamano));
+            tar::escribirOctal(c.size, sizeof(c.size), 0);
+        }
+
+        if (!pax.empty()) {
+            tar::Cabecera x{};
+            memcpy(x.name, "PaxHeader", 9);
+            tar::escribirOctal(x.mode, sizeof(x.mode), 0644);
+            tar::escribirOctal(x.uid, sizeof(x.uid), 0);
+            tar::escribirOctal(x.gid, sizeof(x.gid), 0);
+            tar::escribirOctal(x.size, sizeof(x.size), pax.size());
+            tar::escribirOctal(x.mtime, sizeof(x.mtime), uint64_t(instante));
+            x.typeflag = 'x';
+            memcpy(x.magic, "ustar", 6);
+            memcpy(x.version, "00", 2);
+            tar::escribirOctal(x.chksum, 7, tar::sumaControl(x));
+            x.chksum[7] = ' ';
+            if (!escribir(reinterpret_cast<const char*>(&x), tar::BLOQUE) || !escribir(pax.data(), pax.size()) ||
+                !rellenar(pax.size())) {
+                return false;
+            }
+        }
+
+        tar::escribirOctal(c.mode, sizeof(c.mode), tipo == '5' ? 0755 : 0644);
+        tar::escribirOctal(c.uid, sizeof(c.uid), 0);
+        tar::escribirOctal(c.gid, sizeof(c.gid), 0);
+        tar::escribirOctal(c.mtime, sizeof(c.mtime), uint64_t(instante));
+        c.typeflag = tipo;
+        memcpy(c.magic, "ustar", 6);
+        memcpy(c.version, "00", 2);
+        tar::escribirOctal(c.chksum, 7, tar::sumaControl(c));
+        c.chksum[7] = ' ';
+        return escribir(reinterpret_cast<const char*>(&c), tar::BLOQUE);
+    }
+
+public:
+    bool abrir(const string& ruta) {
+        archivo.open(ruta, ios::binary | ios::trunc);
+        buffer.reserve(tar::TAM_BUFFER);
+        return archivo.is_open();
+    }
+
+    bool carpeta(const string& ruta) {
+        return cabecera(ruta + "/", '5', 0);
+    }
+
+    bool archivoRegular(const string& ruta, const string& contenido) {
+        return cabecera(ruta, '0', contenido.size()) && escribir(contenido.data(), contenido.size()) &&
+               rellenar(contenido.size());
+    }
+
+    // Dos bloques de ceros y vaciado final
+    bool cerrar() {
+        static const char ceros[2 * tar::BLOQUE] = {};
+        bool ok = escribir(ceros, sizeof(ceros)) && vaciarBuffer();
+        archivo.close();
+        return ok && !archivo.fail();
+    }
+
+    uint64_t bytesEscritos() const { return escritos; }
+};
+
+/**
+ * @brief Exporta el subárbol de 'nodo' a un .tar recorriéndolo en preorden (sin recursión).
+ * * Las rutas del archivo empiezan por el nombre del nodo; si es la raíz, por el de cada hijo.
+ */
+inline bool exportarTar(const Nodo* nodo, const string& ruta_archivo, ResultadoTar& r, ostream& errores = cerr) {
+    auto inicio = chrono::steady_clock::now();
+    EscritorTar escritor;
+    if (!escritor.abrir(ruta_archivo)) {
+        errores << "Error: No se pudo crear el archivo '" << ruta_archivo << "'." << endl;
+        return false;
+    }
+
+    vector<pair<const Nodo*, string>> pila;
+    auto apilarHijos = [&](const Nodo* padre, const string& ruta) {
+        for (auto it = padre->hijos.rbegin(); it != padre->hijos.rend(); ++it) {
+            pila.emplace_back(*it, ruta.empty() ? (*it)->nombre.str() : ruta + "/" + (*it)->nombre);
+        }
+    };
+    if (nodo->padre) pila.emplace_back(nodo, nodo->nombre.str());
+    else apilarHijos(nodo, "");
+
+    bool ok = true;
+    while (ok && !pila.empty()) {
+        auto [actual, ruta] = std::move(pila.back());
+        pila.pop_back();
+        if (actual->tipo == TipoNodo::Carpeta) {
+            ok = escritor.carpeta(ruta);
+            ++r.carpetas;
+            apilarHijos(actual, ruta);
+        } else {
+            ok = escritor.archivoRegular(ruta, actual->contenido());
+            ++r.archivos;
+            r.bytes_contenido += actual->contenido().size();
+        }
+    }
+    ok = escritor.cerrar() && ok;
+    if (!ok) {
+        errores << "Error: Fallo al escribir '" << ruta_archivo << "'." << endl;
+        return false;
+    }
+    r.bytes_archivo = escritor.bytesEscritos();
+    r.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    return true;
+}
+
+/**
+ * @brief Lee un .tar de principio a fin y cuelga su contenido de 'destino' (un nodo desvinculado,
+ *        que después se injerta en el árbol).
+ * * El archivo se lee por bloques con un buffer fijo; solo se guarda en memoria el contenido de los
+ *   archivos, que es lo que el árbol necesita.
+ * * Las carpetas intermedias que el archivo no declara se crean; una carpeta declarada dos veces se
+ *   reutiliza y un archivo repetido se sobrescribe (como al extraer con tar). Se omiten las entradas
+ *   con '..', las que chocan con un nodo de otro tipo y los tipos que el árbol no representa
+ *   (enlaces, dispositivos...).
+ */
+inline bool importarTar(const string& ruta_archivo, Nodo* destino, ResultadoTar& r, ostream& errores = cerr) {
+    auto inicio = chrono::steady_clock::now();
+    ifstream archivo(ruta_archivo, ios::binary);
+    if (!archivo.is_open()) {
+        errores << "Error: No se pudo abrir el archivo '" << ruta_archivo << "'." << endl;
+        return false;
+    }
+    vector<char> buffer_lectura(tar::TAM_BUFFER);
+    archivo.rdbuf()->pubsetbuf(buffer_lectura.data(), streamsize(buffer_lectura.size()));
+    // Tamaño del archivo: ninguna entrada puede declarar más datos de los que quedan por leer
+    archivo.seekg(0, ios::end);
+    uint64_t tamano_archivo = uint64_t(archivo.tellg());
+    archivo.seekg(0, ios::beg);
+
+    // Nodos ya creados, por (padre, símbolo del nombre): las rutas se resuelven sin recorrer hijos
+    struct Clave {
+        const Nodo* padre;
+        Simbolo nombre;
+        bool operator==(const Clave& o) const { return padre == o.padre && nombre == o.nombre; }
+    };
+    struct HashClave {
+        size_t operator()(const Clave& c) const { return std::hash<const void*>{}(c.padre) * 31 + c.nombre; }
+    };
+    unordered_map<Clave, Nodo*, HashClave> creados;
+    // Descenso de la entrada anterior: en un tar ordenado casi todas las rutas lo comparten
+    vector<pair<string, Nodo*>> descenso;
+
+    // Hijo 'nombre' de 'padre' con ese tipo, creándolo si falta; nullptr si existe con el otro tipo
+    auto hijo = [&](Nodo* padre, string_view nombre, TipoNodo tipo) -> Nodo* {
+        Nombre n(nombre);
+        auto [it, nuevo] = creados.try_emplace(Clave{padre, n.simbolo()}, nullptr);
+        if (!nuevo) return it->second->tipo == tipo ? it->second : nullptr;
+        it->second = new Nodo(string(nombre), tipo);
+        it->second->padre = padre;
+        padre->hijos.push_back(it->second);
+        ++(tipo == TipoNodo::Carpeta ? r.carpetas : r.archivos);
+        return it->second;
+    };
+
+    tar::Cabecera c;
+    string ruta_pax;
+    uint64_t tamano_pax = 0;
+    bool hay_tamano_pax = false;
+    string datos;
+    auto fallo = [&](const string& motivo) {
+        errores << "Error: '" << ruta_archivo << "' no es un tar valido (" << motivo << ")." << endl;
+        return false;
+    };
+
+    while (true) {
+        if (!archivo.read(reinterpret_cast<char*>(&c), tar::BLOQUE)) return fallo("termina sin bloques de cierre");
+        r.bytes_archivo += tar::BLOQUE;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&c);
+        if (std::all_of(bytes, bytes + tar::BLOQUE, [](unsigned char b) { return b == 0; })) break; // Fin
+        if (tar::leerNumero(c.chksum, sizeof(c.chksum)) != tar::sumaControl(c)) return fallo("suma de control");
+
+        char tipo = c.typeflag;
+        bool extension = tipo == 'x' || tipo == 'g' || tipo == 'L';
+        bool con_datos = extension || tipo == '0' || tipo == '\0' || tipo == '7';
+        uint64_t tamano = (hay_tamano_pax && !extension) ? tamano_pax : tar::leerNumero(c.size, sizeof(c.size));
+        if (tamano > tamano_archivo - r.bytes_archivo) return fallo("tamano");
+        uint64_t relleno = (tar::BLOQUE - tamano % tar::BLOQUE) % tar::BLOQUE;
+
+        // Datos de la entrada (contenido, registros pax o nombre largo GNU)
+        datos.clear();
+        if (con_datos) {
+            datos.resize(size_t(tamano));
+            if (!archivo.read(&datos[0], streamsize(tamano))) return fallo("datos incompletos");
+        } else if (tamano > 0) {
+            archivo.seekg(streamoff(tamano), ios::cur);
+        }
+        archivo.seekg(streamoff(relleno), ios::cur);
+        r.bytes_archivo += tamano + relleno;
+
+        if (extension) {
+            if (tipo == 'L') ruta_pax.assign(datos.c_str());
+            for (size_t i = 0; tipo == 'x' && i < datos.size();) { // "<longitud> clave=valor\n"
+                size_t espacio = datos.find(' ', i);
+                size_t largo = espacio == string::npos ? 0 : strtoull(datos.c_str() + i, nullptr, 10);
+                // El espacio y el '\n' final tienen que caer dentro del propio registro
+                if (largo == 0 || largo > datos.size() - i || espacio + 1 >= i + largo || datos[i + largo - 1] != '\n') {
+                    return fallo("registro pax");
+                }
+                string_view registro(datos.data() + espacio + 1, i + largo - espacio - 2);
+                size_t igual = registro.find('=');
+                if (igual != string_view::npos) {
+                    if (registro.substr(0, igual) == "path") ruta_pax = string(registro.substr(igual + 1));
+                    if (registro.substr(0, igual) == "size") {
+                        tamano_pax = strtoull(string(registro.substr(igual + 1)).c_str(), nullptr, 10);
+                        hay_tamano_pax = true;
+                    }
+                }
+                i += largo;
+            }
+            continue; // Se aplican a la entrada siguiente
+        }
+
+        string ruta = ruta_pax;
+        if (ruta.empty()) {
+            string_view prefijo = tar::campoTexto(c.prefix, sizeof(c.prefix));
+            ruta = string(prefijo) + (prefijo.empty() ? "" : "/") + string(tar::campoTexto(c.name, sizeof(c.name)));
+        }
+        ruta_pax.clear();
+        hay_tamano_pax = false;
+
+        // Segmentos de la ruta, sin '.', separadores repetidos ni '/' inicial
+        vector<string_view> segmentos;
+        bool valida = true;
+        for (size_t i = 0; i < ruta.size();) {
+            size_t fin = ruta.find('/', i);
+            if (fin == string::npos) fin = ruta.size();
+            string_view s(ruta.data() + i, fin - i);
+            if (s == "..") valida = false;
+            if (!s.empty() && s != ".") segmentos.push_back(s);
+            i = fin + 1;
+        }
+        bool es_carpeta = tipo == '5';
+        bool es_archivo = tipo == '0' || tipo == '\0' || tipo == '7';
+        if (!valida || segmentos.empty() || (!es_carpeta && !es_archivo)) {
+            ++r.omitidos;
+            continue;
+        }
+
+        // Carpeta padre: se reutiliza el descenso anterior mientras coincida
+        size_t comun = 0;
+        while (comun < descenso.size() && comun + 1 < segmentos.size() && descenso[comun].first == segmentos[comun]) {
+            ++comun;
+        }
+        descenso.resize(comun);
+        Nodo* padre = comun ? descenso.back().second : destino;
+        for (size_t k = comun; padre && k + 1 < segmentos.size(); ++k) {
+            padre = hijo(padre, segmentos[k], TipoNodo::Carpeta);
+            if (padre) descenso.emplace_back(string(segmentos[k]), padre);
+        }
+        Nodo* nodo = padre ? hijo(padre, segmentos.back(), es_carpeta ? TipoNodo::Carpeta : TipoNodo::Archivo) : nullptr;
+        if (!nodo) {
+            ++r.omitidos;
+            continue;
+        }
+        if (es_archivo) {
+            r.bytes_contenido += tamano - nodo->contenido().size();
+            nodo->fijarContenido(std::move(datos));
+        }
+    }
+    r.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    return true;
+}
+
+#endif // TAR_HPP
@@ -0,0 +1,290 @@
+// Herramienta de trazas de carga de proyectoarbol.
+//
+// Uso:
+//   traza reproducir <traza> [--instantanea ARCHIVO.json] [--ritmo maximo|original] [--persistencia]
+//                            [--formato texto|json]
+//       Vuelve a ejecutar la traza (grabada con 'proyectoarbol --grabar <traza>') sobre la instantánea
+//       indicada (o sobre un árbol vacío) e informa la latencia p50/p90/p99/max de cada comando.
+//       Con --ritmo original cada comando se lanza en su instante grabado y la latencia se mide desde
+//       ese instante, de modo que los retrasos acumulados cuentan (sin omisión coordinada).
+//       save/load/exit se omiten salvo con --persistencia, para no sobrescribir jerarquia.json.
+//
+//   traza generar <traza> [--instantanea ARCHIVO.json] [--nodos N] [--comandos N] [--zipf S]
+//                         [--tasa OPS_S] [--semilla N] [--mezcla ls=40,search=30,...]
+//       Genera un árbol sintético (ver generador.hpp), lo guarda como instantánea y escribe una traza
+//       cuyos nodos se eligen con popularidad Zipf de exponente S. Comandos de la mezcla: ls, search,
+//       touch, rm, mv, rename, export. mv y rename se emiten en parejas de ida y vuelta.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <iomanip>
+#include <cmath>
+
+#include "generador.hpp"
+#include "interprete.hpp"
+#include "histograma.hpp"
+#include "traza.hpp"
+
+using Reloj = chrono::steady_clock;
+
+struct EstadisticaComando {
+    HistogramaLatencia latencias;
+    size_t errores = 0;
+};
+
+static string nombreComando(const string& linea) {
+    stringstream ss(linea);
+    string comando;
+    ss >> comando;
+    return comando;
+}
+
+static int reproducir(const string& ruta, const map<string, string>& opciones, bool persistencia) {
+    auto opcion = [&](const string& clave, const string& defecto) {
+        auto it = opciones.find(clave);
+        return it == opciones.end() ? defecto : it->second;
+    };
+    string ritmo = opcion("--ritmo", "maximo"), formato = opcion("--formato", "texto");
+    if ((ritmo != "maximo" && ritmo != "original") || (formato != "texto" && formato != "json")) {
+        cerr << "Error: --ritmo admite maximo|original y --formato texto|json." << endl;
+        return 1;
+    }
+
+    vector<EntradaTraza> traza;
+    if (!leerTraza(ruta, traza)) return 1;
+
+    ArbolJerarquia arbol;
+    Interprete interprete(arbol);
+    interprete.modoSilencioso(true);
+    string instantanea = opcion("--instantanea", "");
+    if (!instantanea.empty() && !arbol.cargar(instantanea)) return 1;
+
+    ostream nulo(nullptr);
+    ostringstream errores;
+    map<string, EstadisticaComando> por_comando;
+    EstadisticaComando total;
+    size_t omitidos = 0;
+
+    auto inicio = Reloj::now();
+    for (const EntradaTraza& e : traza) {
+        string comando = nombreComando(e.linea);
+        if (comando == "exit" || (!persistencia && (comando == "save" || comando == "load"))) {
+            ++omitidos;
+            continue;
+        }
+        Reloj::time_point desde = Reloj::now();
+        if (ritmo == "original") {
+            Reloj::time_point programado = inicio + chrono::nanoseconds(e.instante_ns);
+            this_thread::sleep_until(programado);
+            desde = programado;
+        }
+        interprete.ejecutar(e.linea, nulo, errores);
+        uint64_t ns = uint64_t(chrono::duration_cast<chrono::nanoseconds>(Reloj::now() - desde).count());
+
+        EstadisticaComando& est = por_comando[comando];
+        est.latencias.registrar(ns);
+        total.latencias.registrar(ns);
+        if (errores.tellp() > 0) {
+            ++est.errores;
+            ++total.errores;
+            errores.str("");
+        }
+    }
+    double segundos = chrono::duration<double>(Reloj::now() - inicio).count();
+
+    auto us = [](uint64_t ns) { return ns / 1000.0; };
+    if (formato == "json") {
+        json j;
+        j["traza"] = ruta;
+        j["ritmo"] = ritmo;
+        j["segundos"] = segundos;
+        j["omitidos"] = omitidos;
+        auto fila = [&](const EstadisticaComando& est) {
+            const HistogramaLatencia& h = est.latencias;
+            return json{{"n", h.cuenta()}, {"errores", est.errores}, {"p50_us", us(h.percentil(0.50))},
+                        {"p90_us", us(h.percentil(0.90))}, {"p99_us", us(h.percentil(0.99))},
+                        {"max_us", us(h.maximo())}};
+        };
+        for (const auto& [comando, est] : por_comando) j["comandos"][comando] = fila(est);
+        j["total"] = fila(total);
+        cout << setw(2) << j << endl;
+        return 0;
+    }
+
+    cout << "Traza " << ruta << ": " << total.latencias.cuenta() << " comandos en " << fixed << setprecision(3)
+         << segundos << " s (ritmo " << ritmo << ", " << omitidos << " omitidos)" << endl;
+    cout << left << setw(10) << "comando" << right << setw(10) << "n" << setw(9) << "errores"
+         << setw(11) << "p50 us" << setw(11) << "p90 us" << setw(11) << "p99 us" << setw(11) << "max us" << endl;
+    auto imprimir = [&](const string& nombre, const EstadisticaComando& est) {
+        const HistogramaLatencia& h = est.latencias;
+        cout << left << setw(10) << nombre << right << setw(10) << h.cuenta() << setw(9) << est.errores
+             << setprecision(1) << setw(11) << us(h.percentil(0.50)) << setw(11) << us(h.percentil(0.90))
+             << setw(11) << us(h.percentil(0.99)) << setw(11) << us(h.maximo()) << endl;
+    };
+    for (const auto& [comando, est] : por_comando) imprimir(comando, est);
+    imprimir("total", total);
+    return 0;
+}
+
+/**
+ * @brief Muestreo de rangos 0..n-1 con probabilidad proporcional a 1/(rango+1)^s.
+ */
+class DistribucionZipf {
+private:
+    vector<double> acumulada;
+
+public:
+    DistribucionZipf(size_t n, double s) : acumulada(n) {
+        double suma = 0;
+        for (size_t k = 0; k < n; ++k) acumulada[k] = (suma += 1.0 / pow(double(k + 1), s));
+        for (double& a : acumulada) a /= suma;
+    }
+
+    size_t operator()(mt19937& gen) {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(gen);
+        size_t k = size_t(lower_bound(acumulada.begin(), acumulada.end(), u) - acumulada.begin());
+        return min(k, acumulada.size() - 1);
+    }
+};
+
+static int generar(const string& ruta, const map<string, string>& opciones) {
+    auto opcion = [&](const string& clave, const string& defecto) {
+        auto it = opciones.find(clave);
+        return it == opciones.end() ? defecto : it->second;
+    };
+    ConfigGenerador config;
+    config.nodos = size_t(stod(opcion("--nodos", "10000")));
+    config.semilla = uint32_t(stoul(opcion("--semilla", "42")));
+    size_t comandos = size_t(stod(opcion("--comandos", "100000")));
+    double s = stod(opcion("--zipf", "1.0"));
+    double tasa = stod(opcion("--tasa", "1000"));
+    string instantanea = opcion("--instantanea", ruta + ".instantanea.json");
+
+    // Mezcla de comandos: nombre=peso
+    vector<pair<string, double>> mezcla;
+    stringstream ss(opcion("--mezcla", "ls=40,search=30,touch=10,rm=5,mv=8,rename=7"));
+    string item;
+    while (getline(ss, item, ',')) {
+        size_t igual = item.find('=');
+        string nombre = item.substr(0, igual);
+        if (igual == string::npos || (nombre != "ls" && nombre != "search" && nombre != "touch" && nombre != "rm" &&
+                                      nombre != "mv" && nombre != "rename" && nombre != "export")) {
+            cerr << "Error: Elemento de --mezcla no valido: '" << item << "'." << endl;
+            return 1;
+        }
+        mezcla.push_back({nombre, stod(item.substr(igual + 1))});
+    }
+    vector<double> pesos;
+    for (const auto& m : mezcla) pesos.push_back(m.second);
+    discrete_distribution<size_t> elegir_comando(pesos.begin(), pesos.end());
+
+    // Árbol base: se guarda como instantánea para reproducir la traza sobre él
+    vector<EntradaNodo> entradas = GeneradorArbol(config).generar();
+    vector<string> archivos, carpetas{"/"};
+    for (const EntradaNodo& e : entradas) (e.tipo == TipoNodo::Archivo ? archivos : carpetas).push_back(e.ruta);
+    if (archivos.empty()) {
+        cerr << "Error: El arbol generado no tiene archivos." << endl;
+        return 1;
+    }
+    {
+        ArbolJerarquia arbol;
+        arbol.modoSilencioso(true);
+        arbol.crearNodos(entradas);
+        if (!arbol.guardar(instantanea)) return 1;
+    }
+
+    // La popularidad no debe seguir el orden de anchura del generador
+    mt19937 gen(config.semilla + 7);
+    shuffle(archivos.begin(), archivos.end(), gen);
+    shuffle(carpetas.begin(), carpetas.end(), gen);
+    DistribucionZipf zipf_archivo(archivos.size(), s), zipf_carpeta(carpetas.size(), s);
+    exponential_distribution<double> llegada(tasa);
+
+    ofstream salida(ruta, ios::trunc);
+    if (!salida.is_open()) {
+        cerr << "Error: No se pudo crear la traza '" << ruta << "'." << endl;
+        return 1;
+    }
+    salida << "# proyectoarbol traza v1 sintetica zipf=" << s << " nodos=" << config.nodos
+           << " semilla=" << config.semilla << " instantanea=" << instantanea << '\n';
+
+    auto nombreDe = [](const string& r) { return r.substr(r.rfind('/') + 1); };
+    auto padreDe = [](const string& r) { return GeneradorArbol::separar(r).first; };
+    auto unir = [](const string& padre, const string& nombre) { return (padre == "/" ? "" : padre) + "/" + nombre; };
+
+    double instante = 0;
+    size_t emitidos = 0, nuevos = 0;
+    vector<string> creados; // Archivos creados por 'touch' y aún no borrados
+    auto emitir = [&](const string& linea) {
+        salida << uint64_t(instante * 1e9) << '\t' << linea << '\n';
+        instante += llegada(gen);
+        ++emitidos;
+    };
+
+    while (emitidos < comandos) {
+        string comando = mezcla[elegir_comando(gen)].first;
+        const string& archivo = archivos[zipf_archivo(gen)];
+        const string& carpeta = carpetas[zipf_carpeta(gen)];
+        if (comando == "rm" && creados.empty()) comando = "touch";
+
+        if (comando == "ls") {
+            emitir("ls " + carpeta);
+        } else if (comando == "search") {
+            emitir("search " + nombreDe(archivo).substr(0, 3));
+        } else if (comando == "export") {
+            emitir("export preorden");
+        } else if (comando == "touch") {
+            string nombre = "z" + to_string(nuevos++) + ".txt";
+            emitir("touch " + carpeta + " " + nombre + " contenido sintetico");
+            creados.push_back(unir(carpeta, nombre));
+        } else if (comando == "rm") {
+            size_t i = uniform_int_distribution<size_t>(0, creados.size() - 1)(gen);
+            emitir("rm " + creados[i]);
+            creados[i] = std::move(creados.back());
+            creados.pop_back();
+        } else if (comando == "mv") {
+            if (padreDe(archivo) == carpeta) continue;
+            emitir("mv " + archivo + " " + carpeta);
+            emitir("mv " + unir(carpeta, nombreDe(archivo)) + " " + padreDe(archivo));
+        } else if (comando == "rename") {
+            emitir("rename " + archivo + " " + nombreDe(archivo) + ".tmp");
+            emitir("rename " + archivo + ".tmp " + nombreDe(archivo));
+        }
+    }
+
+    cerr << "Traza: " << emitidos << " comandos en " << ruta << " (instantanea " << instantanea << ", "
+         << fixed << setprecision(1) << instante << " s a " << setprecision(0) << tasa << " ops/s)" << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    string accion = argc > 2 ? argv[1] : "";
+    map<string, string> opciones;
+    bool persistencia = false, ok = (accion == "reproducir" || accion == "generar");
+    for (int i = 3; ok && i < argc; ++i) {
+        string clave = argv[i];
+        if (clave == "--persistencia") persistencia = true;
+        else if (clave.rfind("--", 0) == 0 && i + 1 < argc) opciones[clave] = argv[++i];
+        else ok = false;
+    }
+    if (!ok) {
+        cerr << "Uso: traza reproducir <traza> [--instantanea ARCHIVO] [--ritmo maximo|original] [--persistencia]"
+                " [--formato texto|json]\n"
+                "     traza generar <traza> [--instantanea ARCHIVO] [--nodos N] [--comandos N] [--zipf S]"
+                " [--tasa OPS_S] [--semilla N] [--mezcla ls=40,search=30,...]" << endl;
+        return 1;
+    }
+    try {
+        return accion == "reproducir" ? reproducir(argv[2], opciones, persistencia) : generar(argv[2], opciones);
+    } catch (const exception& e) { // stod/stoul con valores no numéricos
+        cerr << "Error: Opcion no valida (" << e.what() << ")." << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef TRAZA_HPP
+#define TRAZA_HPP
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <cstdint>
+
+using namespace std;
+
+// ==============================================
+// TRAZAS DE CARGA (grabación y lectura)
+// ==============================================
+//
+// Formato de texto, una línea por comando:
+//     <nanosegundos desde el inicio de la grabación>\t<línea de comando tal cual>
+// Las líneas que empiezan por '#' son comentarios (la primera lleva la versión y la hora de inicio).
+
+struct EntradaTraza {
+    uint64_t instante_ns; // Desde el inicio de la grabación (reloj monótono)
+    string linea;
+};
+
+/**
+ * @brief Graba cada línea de comando con su instante relativo al inicio de la grabación.
+ * * La escritura va con buffer; el archivo se vacía al destruir el grabador (o con vaciar()).
+ */
+class GrabadorTraza {
+private:
+    ofstream archivo;
+    chrono::steady_clock::time_point inicio;
+    size_t grabados = 0;
+
+public:
+    bool abrir(const string& ruta) {
+        archivo.open(ruta, ios::trunc);
+        if (!archivo.is_open()) return false;
+        inicio = chrono::steady_clock::now();
+        archivo << "# proyectoarbol traza v1 inicio=" << long(time(nullptr)) << '\n';
+        return true;
+    }
+
+    bool activo() const { return archivo.is_open(); }
+    size_t comandosGrabados() const { return grabados; }
+
+    void registrar(string_view linea) {
+        if (!archivo.is_open() || linea.find_first_not_of(" \t\r") == string_view::npos) return;
+        auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count();
+        archivo << ns << '\t' << linea << '\n';
+        ++grabados;
+    }
+
+    void vaciar() { archivo.flush(); }
+};
+
+/**
+ * @brief Lee una traza completa. Devuelve false si el archivo no existe o tiene líneas mal formadas.
+ */
+inline bool leerTraza(const string& ruta, vector<EntradaTraza>& entradas, ostream& errores = cerr) {
+    ifstream archivo(ruta);
+    if (!archivo.is_open()) {
+        errores << "Error: No se pudo abrir la traza '" << ruta << "'." << endl;
+        return false;
+    }
+    string linea;
+    size_t numero = 0;
+    while (getline(archivo, linea)) {
+        ++numero;
+        if (linea.empty() || linea[0] == '#') continue;
+        size_t tab = linea.find('\t');
+        if (tab == string::npos || tab == 0 || linea.find_first_not_of("0123456789") != tab) {
+            errores << "Error: Linea " << numero << " de la traza mal formada." << endl;
+            return false;
+        }
+        entradas.push_back({stoull(linea.substr(0, tab)), linea.substr(tab + 1)});
+    }
+    return true;
+}
+
+#endif // TRAZA_HPP